@@ -0,0 +1,162 @@
+#ifdef _WIN32 // Used in "text_fonts_glyphs.h" to memory-map text bundles.
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp> // Used in "text_fonts_glyphs.h" for the projection: glm::ortho(...)
+#include <glm/gtc/type_ptr.hpp>
+
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <queue>
+#include <climits>
+#include <cfloat>
+#include <memory_resource>
+#include <cstddef>
+#include <charconv>
+#include <deque>
+#include <string_view>
+#include <cmath>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+
+#include "../Project/job_system.h"
+#include "../Project/mpsc_queue.h"
+#include "../Project/text_renderer.h" // The text core runs headless here (no GL)... save_text_bundle(...) never calls the renderer anyway.
+#include "../Project/text_fonts_glyphs.h"
+
+// Offline text asset compiler: text_compiler <manifest> <output bundle>
+// ----------------------------------------------------------------------------
+// The manifest is UTF-8 text, 1 directive per line ('#' starts a comment line):
+//
+//    dpi 1.5                                      The DPI (content) scale the atlases are rasterised for (optional, defaults to 1... layout is in pixels, so no window size is needed)
+//    alphabet 1234567890abc...                    Characters packed into every atlas (the rest of the line... defaults to the demo's alphabet)
+//    fallback ../Text Fonts/symbols.ttf           Appends a fallback font, applied to the "font" lines that follow.
+//    font 70 ../Text Fonts/BOOKOSB.ttf            Starts a new source: font size, then the font path (the rest of the line)
+//    strings ../Strings/menu_en.txt               Appends a string table (1 string per line) to the current source.
+//
+// The bundle's strings are numbered in manifest order... pass that number (plus the index returned by load_text_bundle(...)) to create_bundle_message(...)
+
+std::string rest_of_line(std::istringstream& line)
+{
+	std::string rest;
+	std::getline(line >> std::ws, rest);
+	return rest;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 3)
+	{
+		std::cout << "\n   Usage: text_compiler <manifest> <output bundle>\n";
+		return 1;
+	}
+	std::ifstream manifest(argv[1]);
+	if (!manifest.is_open())
+	{
+		std::cout << "\n   Error: could not open manifest: " << argv[1] << "\n";
+		return 1;
+	}
+	float dpi_scale = 1.0f;
+	std::string alphabet = "1234567890&.-abcdefghijklmnopqrstuvwxyz:_ABCDEFGHIJKLMNOPQRSTUVWXYZ ";
+	std::vector<std::string> fallback_font_paths;
+	std::vector<Text::Bundle_Source> sources;
+	unsigned string_count = 0;
+
+	std::string manifest_line;
+	for (unsigned line_number = 1; std::getline(manifest, manifest_line); ++line_number)
+	{
+		if (!manifest_line.empty() && manifest_line.back() == '\r')
+			manifest_line.pop_back();
+
+		std::istringstream line(manifest_line);
+		std::string directive;
+		line >> directive;
+
+		if (directive.empty() || directive[0] == '#')
+			continue;
+
+		if (directive == "dpi")
+			line >> dpi_scale;
+		else if (directive == "alphabet")
+			alphabet = rest_of_line(line);
+		else if (directive == "fallback")
+			fallback_font_paths.push_back(rest_of_line(line));
+		else if (directive == "font")
+		{
+			Text::Bundle_Source source;
+			line >> source.font_size;
+			source.font_path = rest_of_line(line);
+			source.fallback_font_paths = fallback_font_paths;
+			sources.push_back(source);
+		}
+		else if (directive == "strings" && !sources.empty())
+		{
+			std::string table_path = rest_of_line(line);
+			std::ifstream table(table_path);
+			if (!table.is_open())
+			{
+				std::cout << "\n   Error: could not open string table: " << table_path << "\n";
+				return 1;
+			}
+			std::string string;
+			while (std::getline(table, string))
+			{
+				if (!string.empty() && string.back() == '\r')
+					string.pop_back();
+
+				std::cout << "\n   String " << string_count++ << ": " << string;
+				sources.back().strings.push_back(string);
+			}
+		}
+		else
+		{
+			std::cout << "\n   Error: " << argv[1] << " line " << line_number << " --- unknown (or misplaced) directive: " << directive << "\n";
+			return 1;
+		}
+	}
+	if (dpi_scale <= 0.0f || sources.empty())
+	{
+		std::cout << "\n   Error: the manifest needs at least 1 \"font\" (and any \"dpi\" scale must be positive)\n";
+		return 1;
+	}
+	FT_Library free_type;
+	FT_Error error_code = FT_Init_FreeType(&free_type);
+	if (error_code)
+	{
+		std::cout << "\n   Error code: " << error_code << " --- " << "An error occurred during initialising the FT_Library";
+		return 1;
+	}
+	bool saved = false;
+	{
+		Text_Renderer_Headless renderer;
+		Text text_compiler(renderer, free_type, 1, 1, alphabet); // Destroyed before FT_Done_FreeType(...)... its faces were all private, so are already closed.
+		text_compiler.set_dpi_scale(dpi_scale); // Nothing created yet, so nothing is re-rasterised.
+		saved = text_compiler.save_text_bundle(argv[2], sources);
+	}
+	FT_Done_FreeType(free_type);
+
+	std::cout << "\n\n   " << (saved ? "Saved: " : "Error: could not write: ") << argv[2] << "\n";
+	return saved ? 0 : 1;
+}
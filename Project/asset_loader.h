@@ -0,0 +1,271 @@
+#pragma once // C++20 coroutine asset loading (fonts, shaders & textures)... the file reads & decoding run as jobs, then each load resumes on the GL thread for its upload.
+ 
+// Each load is an Asset_Task<T> coroutine, which moves between threads by co_await-ing:
+//    co_await loader.on_worker()        Resumes as a job on the Job_System (file reads, FreeType, image decoding)
+//    co_await loader.on_gl_thread()     Resumes in the GL thread's next call to: pump()   (uploads, shader compilation)
+// so a scene's fonts, shaders & textures all load at once... startup overlaps the I/O, rasterising, decoding and compiling, rather than running them 1 after another.
+template <typename T>
+class Asset_Task
+{
+public:
+	struct promise_type
+	{
+		T value{};
+		std::atomic<bool> finished{ false };
+		std::atomic<void*> continuation{ nullptr }; // The coroutine co_await-ing this one (null until awaited, "finished_marker" once finished without one)
+		bool started = false; // By start(), or by being co_await-ed (owner thread only)
+ 
+		Asset_Task get_return_object()
+		{
+			return Asset_Task(std::coroutine_handle<promise_type>::from_promise(*this));
+		}
+		std::suspend_always initial_suspend() noexcept // Lazy: runs once started, or co_await-ed.
+		{
+			return {};
+		}
+		struct Final_Awaiter
+		{
+			bool await_ready() noexcept
+			{
+				return false;
+			}
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+			{
+				void* continuation = handle.promise().continuation.exchange(&finished_marker, std::memory_order_acq_rel); // Read 1st: once "finished" is set, the task's owner may destroy this frame.
+				handle.promise().finished.store(true, std::memory_order_release);
+				return continuation ? std::coroutine_handle<>::from_address(continuation) : std::noop_coroutine();
+			}
+			void await_resume() noexcept
+			{
+			}
+		};
+		Final_Awaiter final_suspend() noexcept
+		{
+			return {};
+		}
+		void return_value(T new_value)
+		{
+			value = std::move(new_value);
+		}
+		void unhandled_exception() // Loads report their errors as warnings (and return an empty value) rather than throwing.
+		{
+			std::terminate();
+		}
+	};
+ 
+	explicit Asset_Task(std::coroutine_handle<promise_type> handle) : handle(handle)
+	{
+	}
+	Asset_Task(Asset_Task&& other) noexcept : handle(std::exchange(other.handle, {}))
+	{
+	}
+	Asset_Task(const Asset_Task&) = delete;
+	Asset_Task& operator=(const Asset_Task&) = delete;
+ 
+	~Asset_Task() // Keep a started task until: ready()
+	{
+		if (handle)
+			handle.destroy();
+	}
+ 
+	void start() // Runs the load on the calling thread until its 1st co_await... it may still be co_await-ed later, e.g. to run several loads at once, then wait on each.
+	{
+		handle.promise().started = true;
+		handle.resume();
+	}
+	bool ready() const
+	{
+		return handle.promise().finished.load(std::memory_order_acquire);
+	}
+	T& result()
+	{
+		return handle.promise().value;
+	}
+ 
+	// co_await-ing a task starts it (unless already started), and resumes the awaiting coroutine (on whichever thread the task finished on) with its result.
+	bool await_ready() const noexcept
+	{
+		return false;
+	}
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+	{
+		promise_type& promise = handle.promise();
+		if (!promise.started)
+		{
+			promise.started = true;
+			promise.continuation.store(awaiting.address(), std::memory_order_relaxed);
+			return handle;
+		}
+		void* expected = nullptr; // Already running elsewhere... either it picks "awaiting" up when it finishes, or it has already finished.
+		if (promise.continuation.compare_exchange_strong(expected, awaiting.address(), std::memory_order_acq_rel, std::memory_order_acquire))
+			return std::noop_coroutine();
+ 
+		return awaiting;
+	}
+	T await_resume()
+	{
+		return std::move(handle.promise().value);
+	}
+ 
+private:
+	std::coroutine_handle<promise_type> handle;
+	static inline char finished_marker = 0; // Its address marks a task that finished before anything co_await-ed it.
+};
+ 
+class Asset_Loader
+{
+public:
+	Asset_Loader(Job_System& jobs) : jobs(jobs) // e.g. Text::jobs(), so the loads share the text's workers.
+	{
+	}
+ 
+	struct Worker_Awaiter
+	{
+		Job_System& jobs;
+ 
+		bool await_ready() const noexcept
+		{
+			return false;
+		}
+		void await_suspend(std::coroutine_handle<> handle)
+		{
+			jobs.submit([handle]() { handle.resume(); });
+		}
+		void await_resume() const noexcept
+		{
+		}
+	};
+	struct GL_Thread_Awaiter
+	{
+		MPSC_Queue<std::coroutine_handle<>>& gl_resumes;
+ 
+		bool await_ready() const noexcept
+		{
+			return false;
+		}
+		void await_suspend(std::coroutine_handle<> handle)
+		{
+			gl_resumes.push(handle);
+		}
+		void await_resume() const noexcept
+		{
+		}
+	};
+	Worker_Awaiter on_worker()
+	{
+		return { jobs };
+	}
+	GL_Thread_Awaiter on_gl_thread()
+	{
+		return { gl_resumes };
+	}
+ 
+	// GL thread, once per frame (or in a loop while loading)... resumes every load that has asked for the GL thread since the last call.
+	// Loads asking again while being resumed wait for the next call, so this always returns... returns how many were resumed.
+	unsigned pump()
+	{
+		resuming.clear();
+ 
+		std::coroutine_handle<> handle;
+		while (gl_resumes.pop(handle))
+			resuming.push_back(handle);
+ 
+		for (unsigned i = 0; i < resuming.size(); ++i)
+			resuming[i].resume();
+ 
+		return (unsigned)resuming.size();
+	}
+ 
+	// The whole file, read as a job (the awaiting load then carries on from that job)... empty if it can't be opened.
+	Asset_Task<std::vector<unsigned char>> read_file(std::string path)
+	{
+		co_await on_worker();
+ 
+		std::vector<unsigned char> bytes;
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+ 
+		if (!file.is_open())
+		{
+			std::cout << "\n   Warning: Asset_Loader::read_file(...) --- could not open: " << path;
+			co_return bytes;
+		}
+		bytes.resize((size_t)file.tellg());
+		file.seekg(0);
+		file.read((char*)bytes.data(), bytes.size());
+ 
+		co_return bytes;
+	}
+ 
+	// Both files are read at once (as 2 jobs), then compiled & linked on the GL thread into "shader" (which must outlive the load)... false if either file couldn't be read.
+	Asset_Task<bool> load_shader(Shader& shader, std::string vert_path, std::string frag_path)
+	{
+		Asset_Task<std::vector<unsigned char>> vert_read = read_file(vert_path);
+		Asset_Task<std::vector<unsigned char>> frag_read = read_file(frag_path);
+		vert_read.start(); // Both queued before either is awaited, so the reads overlap.
+		frag_read.start();
+ 
+		std::vector<unsigned char> vert_bytes = co_await vert_read;
+		std::vector<unsigned char> frag_bytes = co_await frag_read;
+ 
+		co_await on_gl_thread();
+ 
+		if (vert_bytes.empty() || frag_bytes.empty())
+			co_return false;
+ 
+		shader.create_program(std::string(vert_bytes.begin(), vert_bytes.end()), std::string(frag_bytes.begin(), frag_bytes.end()));
+		co_return true;
+	}
+ 
+	// Read & decoded (stb_image, as RGBA) as a job, then uploaded with mipmaps on the GL thread... returns the texture (0 if it couldn't be loaded)
+	Asset_Task<unsigned> load_texture(std::string path)
+	{
+		std::vector<unsigned char> bytes = co_await read_file(path);
+ 
+		int width = 0, height = 0, channels = 0;
+		stbi_set_flip_vertically_on_load_thread(1); // OpenGL's 1st texture row is the bottom one... set per thread, so concurrent decodes can't disturb one another.
+ 
+		unsigned char* pixels = bytes.empty() ? nullptr : stbi_load_from_memory(bytes.data(), (int)bytes.size(), &width, &height, &channels, 4);
+		if (!pixels)
+		{
+			std::cout << "\n   Warning: Asset_Loader::load_texture(...) --- could not decode: " << path << (bytes.empty() ? "" : " --- ") << (bytes.empty() ? "" : stbi_failure_reason());
+			co_return 0;
+		}
+		co_await on_gl_thread();
+ 
+		unsigned texture = 0;
+		glGenTextures(1, &texture);
+		glBindTexture(GL_TEXTURE_2D, texture);
+ 
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+		glGenerateMipmap(GL_TEXTURE_2D);
+ 
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+ 
+		glBindTexture(GL_TEXTURE_2D, 0);
+		stbi_image_free(pixels);
+ 
+		co_return texture;
+	}
+ 
+	// The font is opened & its alphabet rasterised as a job, then streamed in by Text::update_async_uploads() (call it along with pump() while loading)
+	// Completes (true) once messages using "font_path" & "font_size" can be created without waiting.
+	Asset_Task<bool> load_font(Text& text, std::string font_path, int font_size)
+	{
+		co_await on_gl_thread(); // "text" is only used from the GL thread.
+ 
+		text.preload_alphabet_async(font_path, font_size);
+ 
+		while (!text.alphabet_ready(font_path, font_size))
+			co_await on_gl_thread(); // Checked again in each pump()
+ 
+		co_return true;
+	}
+ 
+private:
+	Job_System& jobs;
+	MPSC_Queue<std::coroutine_handle<>> gl_resumes; // Loads waiting for the GL thread (pushed from any thread)
+	std::vector<std::coroutine_handle<>> resuming; // pump()'s batch (capacity is kept between calls)
+};
@@ -0,0 +1,227 @@
+#pragma once // Work-stealing job system... used by "text_fonts_glyphs.h" to rasterise alphabets & lay out messages across every core.
+ 
+// Each worker owns a deque: it pushes & pops its own jobs at the back (newest first, so still warm in its cache), while idle workers steal from the front of the others' (oldest first, usually the largest remaining work)
+// The deques are std::deque behind a mutex each (not lock-free)... a lock is only held for 1 push or pop, and each worker mostly touches only its own.
+// Jobs submitted from outside the workers (e.g. the GL thread) go into a shared injection deque. A job can depend on earlier jobs, and is only queued once they've all finished.
+// Threads waiting on a job run other queued jobs meanwhile, rather than blocking... so jobs may themselves submit & wait on jobs.
+class Job_System
+{
+	struct Job
+	{
+		std::function<void()> function;
+		std::atomic<unsigned> unfinished_prerequisites{ 1 }; // +1 while still being submitted, so it can't be queued before all its prerequisites are registered.
+ 
+		std::mutex dependents_mutex;
+		std::vector<std::shared_ptr<Job>> dependents; // Queued (once their other prerequisites are done too) when this job finishes.
+		std::atomic<bool> finished{ false };
+	};
+ 
+public:
+	typedef std::shared_ptr<Job> Job_Handle; // Null = no job (treated as already finished)
+ 
+	Job_System(unsigned worker_count) : worker_count(worker_count > 0 ? worker_count : 1) // std::thread::hardware_concurrency() can return 0 when the core count is unknown.
+	{
+		deques = std::vector<Job_Deque>(this->worker_count + 1); // The last is the injection deque... sized before any worker starts.
+ 
+		for (unsigned i = 0; i < this->worker_count; ++i)
+			workers.push_back(std::thread(&Job_System::worker_loop, this, i));
+	}
+ 
+	~Job_System() // Every job already queued is finished first.
+	{
+		{
+			std::lock_guard<std::mutex> lock(sleep_mutex);
+			stopping = true;
+		}
+		sleep_condition.notify_all();
+ 
+		for (unsigned i = 0; i < workers.size(); ++i)
+			workers[i].join();
+	}
+ 
+	unsigned size() const
+	{
+		return worker_count;
+	}
+ 
+	// Any thread... "function" runs on a worker once every job in "prerequisites" has finished.
+	Job_Handle submit(std::function<void()> function, const std::vector<Job_Handle>& prerequisites = {})
+	{
+		Job_Handle job = std::make_shared<Job>();
+		job->function = std::move(function);
+ 
+		for (const Job_Handle& prerequisite : prerequisites)
+		{
+			if (!prerequisite)
+				continue;
+ 
+			std::lock_guard<std::mutex> lock(prerequisite->dependents_mutex);
+			if (!prerequisite->finished.load(std::memory_order_acquire))
+			{
+				job->unfinished_prerequisites.fetch_add(1, std::memory_order_relaxed);
+				prerequisite->dependents.push_back(job);
+			}
+		}
+		if (job->unfinished_prerequisites.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			enqueue(job);
+ 
+		return job;
+	}
+ 
+	static bool finished(const Job_Handle& job)
+	{
+		return !job || job->finished.load(std::memory_order_acquire);
+	}
+ 
+	// Runs other jobs until "job" has finished (so the calling thread helps, rather than sitting idle)
+	void wait(const Job_Handle& job)
+	{
+		while (!finished(job))
+		{
+			if (!run_one_job())
+				std::this_thread::yield(); // Nothing left to help with... "job" is running on another thread.
+		}
+	}
+ 
+	void wait(const std::vector<Job_Handle>& jobs)
+	{
+		for (const Job_Handle& job : jobs)
+			wait(job);
+	}
+ 
+	// Calls function(i) for every i in [0, count)... the indices are shared out between 1 job per worker and the calling thread, and it returns once all are done.
+	void parallel_for(unsigned count, const std::function<void(unsigned)>& function)
+	{
+		std::atomic<unsigned> next_index(0);
+ 
+		auto run_indices = [&]()
+		{
+			for (unsigned i = next_index++; i < count; i = next_index++)
+				function(i);
+		};
+		unsigned helper_count = (count > 1) ? std::min(size(), count - 1) : 0;
+ 
+		std::vector<Job_Handle> helpers;
+		for (unsigned i = 0; i < helper_count; ++i)
+			helpers.push_back(submit(run_indices));
+ 
+		run_indices(); // The calling thread works too.
+		wait(helpers);
+	}
+ 
+private:
+	struct Job_Deque
+	{
+		std::mutex mutex; // Held only for a push or pop (never while a job runs)
+		std::deque<Job_Handle> jobs;
+	};
+	const unsigned worker_count; // Workers only read this (never "workers", which is still growing as they start)
+	std::vector<Job_Deque> deques; // 1 per worker, then the injection deque.
+	std::vector<std::thread> workers;
+ 
+	std::atomic<unsigned> queued_jobs{ 0 };
+	std::mutex sleep_mutex; // Idle workers sleep until a job is queued.
+	std::condition_variable sleep_condition;
+	bool stopping = false;
+ 
+	struct Worker_Identity
+	{
+		const Job_System* system = nullptr;
+		unsigned index = 0;
+	};
+	static Worker_Identity& this_worker() // Which deque the calling thread owns (if any)
+	{
+		static thread_local Worker_Identity identity;
+		return identity;
+	}
+ 
+	void enqueue(const Job_Handle& job)
+	{
+		const Worker_Identity& identity = this_worker();
+		Job_Deque& deque = (identity.system == this) ? deques[identity.index] : deques.back();
+ 
+		queued_jobs.fetch_add(1, std::memory_order_release); // Counted before it can be taken, so a thief's decrement can't wrap the count below 0.
+		{
+			std::lock_guard<std::mutex> lock(deque.mutex);
+			deque.jobs.push_back(job);
+		}
+		{
+			std::lock_guard<std::mutex> lock(sleep_mutex); // So a worker about to sleep can't miss this job.
+		}
+		sleep_condition.notify_one();
+	}
+ 
+	Job_Handle take_job()
+	{
+		const Worker_Identity& identity = this_worker();
+		unsigned own_index = (identity.system == this) ? identity.index : (unsigned)deques.size() - 1;
+		Job_Handle job;
+ 
+		if (own_index < worker_count) // Own deque: newest first.
+		{
+			Job_Deque& own = deques[own_index];
+			std::lock_guard<std::mutex> lock(own.mutex);
+			if (!own.jobs.empty())
+			{
+				job = std::move(own.jobs.back());
+				own.jobs.pop_back();
+			}
+		}
+		for (unsigned offset = 0; !job && offset <= worker_count; ++offset) // Steal (oldest first): the injection deque, then each other worker's in turn.
+		{
+			unsigned victim_index = (offset == 0) ? worker_count : (own_index + offset) % worker_count;
+			if (victim_index == own_index && offset > 0)
+				continue;
+ 
+			Job_Deque& victim = deques[victim_index];
+			std::lock_guard<std::mutex> lock(victim.mutex);
+			if (!victim.jobs.empty())
+			{
+				job = std::move(victim.jobs.front());
+				victim.jobs.pop_front();
+			}
+		}
+		if (job)
+			queued_jobs.fetch_sub(1, std::memory_order_relaxed);
+		return job;
+	}
+ 
+	bool run_one_job()
+	{
+		Job_Handle job = take_job();
+		if (!job)
+			return false;
+ 
+		job->function();
+		job->function = nullptr; // Release its captures now, rather than when the last handle goes.
+ 
+		std::vector<Job_Handle> dependents;
+		{
+			std::lock_guard<std::mutex> lock(job->dependents_mutex);
+			job->finished.store(true, std::memory_order_release);
+			dependents.swap(job->dependents);
+		}
+		for (const Job_Handle& dependent : dependents)
+			if (dependent->unfinished_prerequisites.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				enqueue(dependent);
+		return true;
+	}
+ 
+	void worker_loop(unsigned index)
+	{
+		this_worker().system = this;
+		this_worker().index = index;
+ 
+		while (true)
+		{
+			if (run_one_job())
+				continue;
+ 
+			std::unique_lock<std::mutex> lock(sleep_mutex);
+			sleep_condition.wait(lock, [this]() { return stopping || queued_jobs.load(std::memory_order_acquire) > 0; });
+ 
+			if (stopping && queued_jobs.load(std::memory_order_acquire) == 0)
+				return;
+		}
+	}
+};
@@ -1,3 +1,14 @@
+#ifdef _WIN32 // Used in "text_fonts_glyphs.h" to memory-map text bundles (included first, so that glad.h's APIENTRY isn't redefined)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #include <glad/glad.h> // GLAD: https://github.com/Dav1dde/glad GLAD 2 also works via the web-service: https://gen.glad.sh/ (leaving all checkbox options unchecked)
 #include <GLFW/glfw3.h>
 
@@ -13,11 +24,41 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include <vector>
+#include <map> // Used in "text_fonts_glyphs.h" for the fallback faces & codepoint cache.
+#include <unordered_map>
+#include <memory> // Used in "text_fonts_glyphs.h" for the async font loading (worker threads & PBO uploads)
+#include <mutex>
+#include <chrono>
+#include <cstring>
+#include <algorithm> // Used in "text_fonts_glyphs.h" to order the glyph usage profile.
+#include <thread> // Used in "job_system.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <queue>
+#include <climits>
+#include <cfloat>
+#include <memory_resource> // Used in "text_fonts_glyphs.h" for the message arena (C++17)
+#include <cstddef> // Used in "text_fonts_glyphs.h" for std::byte (the immediate-mode frame arena buffer)
+#include <charconv> // Used in "text_fonts_glyphs.h" for std::to_chars (numeric-field messages)
+#include <deque> // Used in "text_fonts_glyphs.h" for the text measurement fonts.
+#include <string_view>
+#include <cmath>
 #include <iostream>
 #include <fstream> // Used in "shader_configure.h" to read the shader text files.
+#include <coroutine> // Used in "asset_loader.h" (C++20)
+#include <utility> // Used in "asset_loader.h" for: std::exchange
+
+#define STB_IMAGE_IMPLEMENTATION // Used in "asset_loader.h" to decode the textures.
+#include <stb_image.h>
 
 #include "shader_configure.h" // Used to create the shaders.
+#include "job_system.h" // Used in "text_fonts_glyphs.h" for the alphabet rasterisation & message layout jobs.
+#include "mpsc_queue.h" // Used in "text_fonts_glyphs.h" for the text command queue.
+#include "text_renderer.h" // The renderer interface "text_fonts_glyphs.h" draws through...
+#include "text_renderer_gl.h" // ...and its OpenGL 4.2 backend.
 #include "text_fonts_glyphs.h"
+#include "asset_loader.h" // Loads the shaders, font & texture concurrently (C++20 coroutines)
 
 int main()
 {
@@ -63,17 +104,11 @@ int main()
 	glEnable(GL_BLEND); // GL_BLEND for OpenGL transparency which is further set within the fragment shader. 
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-	// (3) Compile Shaders & Initialise Camera 
-   // -----------------------------------------------------
+	// (3) Load the Shaders, Font & Texture (all at once, as coroutines... see: "asset_loader.h")
+   // -----------------------------------------------------------------------------------------------------
 	const char* vert_shader_text = "../Shaders/shader_glsl.vert";
 	const char* frag_shader_text = "../Shaders/shader_glsl.frag";
 
-	Shader text_shader(vert_shader_text, frag_shader_text);
-	text_shader.use();		
-	
-	Shader text_shader2(vert_shader_text, frag_shader_text);
-	text_shader2.use();	
-
 	FT_Library free_type;
 	FT_Error error_code = FT_Init_FreeType(&free_type);
 	if (error_code)
@@ -82,7 +117,47 @@ int main()
 		int keep_console_open;
 		std::cin >> keep_console_open;
 	}
-	Text text_object1(free_type, window_width, window_height, "1234567890&.-abcdefghijklmnopqrstuvwxyz:_ABCDEFGHIJKLMNOPQRSTUVWXYZ "); // Pass a specific alphabet to be used for this specific text object.
+	int framebuffer_width, framebuffer_height; // Text is laid out in pixels... the framebuffer can be larger than the window on high-DPI monitors.
+	glfwGetFramebufferSize(window, &framebuffer_width, &framebuffer_height);
+	float content_scale_x, content_scale_y;
+	glfwGetWindowContentScale(window, &content_scale_x, &content_scale_y);
+
+	Text_Renderer_GL text_renderer; // Declared before the Text object, so it outlives it.
+	Text text_object1(text_renderer, free_type, framebuffer_width, framebuffer_height, "1234567890&.-abcdefghijklmnopqrstuvwxyz:_ABCDEFGHIJKLMNOPQRSTUVWXYZ "); // Pass a specific alphabet to be used for this specific text object.
+	text_object1.set_dpi_scale(content_scale_y); // Before any messages are created, so nothing needs re-rasterising.
+
+	Asset_Loader asset_loader(text_object1.jobs());
+	Shader text_shader, text_shader2;
+	Shader grid_shader; // Used by terminal grids, via: draw_terminal_grids(...)
+
+	std::vector<Asset_Task<bool>> loads;
+	loads.push_back(asset_loader.load_shader(text_shader, vert_shader_text, frag_shader_text));
+	loads.push_back(asset_loader.load_shader(text_shader2, vert_shader_text, frag_shader_text));
+	loads.push_back(asset_loader.load_shader(grid_shader, "../Shaders/terminal_grid.vert", "../Shaders/terminal_grid.frag"));
+	loads.push_back(asset_loader.load_font(text_object1, "../x64/Release/Text Fonts/BOOKOSB.ttf", 70));
+	Asset_Task<unsigned> shiny_texture = asset_loader.load_texture("../Textures/shiny_texture.png"); // Not drawn by this demo yet.
+
+	for (unsigned i = 0; i < loads.size(); ++i)
+		loads[i].start();
+	shiny_texture.start();
+
+	bool loading = true;
+	while (loading) // The files are read, and the font & texture decoded, on the worker threads... this thread compiles & uploads each one as it arrives.
+	{
+		asset_loader.pump();
+		text_object1.update_async_uploads(); // Streams in the font's alphabet.
+		glfwPollEvents();
+
+		loading = !shiny_texture.ready();
+		for (unsigned i = 0; i < loads.size(); ++i)
+			loading = loading || !loads[i].ready();
+	}
+	text_shader.use();
+	text_shader2.use();
+
+	text_object1.upload_projection(text_shader.ID);
+	text_object1.upload_projection(text_shader2.ID);
+	text_object1.upload_projection(grid_shader.ID);
 	text_object1.create_text_message("END LIFE", 110, 60, "../x64/Release/Text Fonts/BOOKOSB.ttf", 70, false);
 	//text_object1.create_text_message("_", 110, 45, "../x64/Release/Text Fonts/BOOKOSB.ttf", 90, false);
 
@@ -107,9 +182,34 @@ int main()
 		glClearColor(128.0f / 255, 128.0f / 255, 128.0f / 255, 1.0f); // This line can be moved to before the while loop.
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+		int new_width, new_height; // Resizing only updates the projection uniform... nothing is laid out again.
+		float new_scale_x, new_scale_y;
+		glfwGetFramebufferSize(window, &new_width, &new_height);
+		glfwGetWindowContentScale(window, &new_scale_x, &new_scale_y);
+
+		if ((new_width != framebuffer_width || new_height != framebuffer_height || new_scale_y != content_scale_y) && new_width > 0 && new_height > 0) // 0 x 0 while minimised.
+		{
+			framebuffer_width = new_width;
+			framebuffer_height = new_height;
+			content_scale_y = new_scale_y;
+			glViewport(0, 0, framebuffer_width, framebuffer_height);
+
+			text_object1.set_window_size(framebuffer_width, framebuffer_height);
+			text_object1.set_dpi_scale(content_scale_y); // Moved to a monitor with a different scale: the alphabets are re-rasterised in the background.
+			text_object1.upload_projection(text_shader.ID);
+			text_object1.upload_projection(text_shader2.ID);
+			text_object1.upload_projection(grid_shader.ID);
+		}
+
 		// (8) Draw the Alphabets & Messages
 		// -----------------------------------------------
+		text_object1.apply_text_commands(); // Applies any messages created, edited or removed from other threads via: submit_create_message(...) etc.
+		text_object1.update_async_uploads(); // Only does work while messages created via: create_text_message_async(...) are still waiting on their glyphs.
 		text_object1.draw_messages();
+		text_object1.draw_documents(); // Only the visible chunks of any virtualized documents.
+		text_object1.draw_logs(); // Streaming logs: only their visible lines, straight from each ring of quads.
+		text_object1.draw_immediate_text(); // Draws (then forgets) any text queued this frame via: draw_text(...)
+		text_object1.draw_terminal_grids(grid_shader.ID);
 
 		glfwSwapBuffers(window);
 		glfwPollEvents();
@@ -119,8 +219,13 @@ int main()
 	// ------------------------------
 	// FT_Done_Face(text_object1.face);
 	FT_Done_Face(text_object1.face);
+	for (std::map<std::string, FT_Face>::iterator it = text_object1.fallback_faces.begin(); it != text_object1.fallback_faces.end(); ++it)
+		FT_Done_Face(it->second);
 	FT_Done_FreeType(free_type);
 	glDeleteProgram(text_shader.ID);
+	glDeleteProgram(text_shader2.ID);
+	glDeleteProgram(grid_shader.ID);
+	glDeleteTextures(1, &shiny_texture.result());
 
 	/* glfwDestroyWindow(window) // Call this function to destroy a specific window */
 	glfwTerminate(); // Destroys all remaining windows and cursors, restores modified gamma ramps, and frees resources.
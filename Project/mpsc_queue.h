@@ -0,0 +1,59 @@
+#pragma once // Lock-free multi-producer, single-consumer queue... used by "text_fonts_glyphs.h" for commands submitted from game threads, applied on the GL thread.
+ 
+// Intrusive linked list (Vyukov): push() is a single atomic exchange (never blocks, never retries), pop() is only ever called by the 1 consumer thread.
+// A pushed item becomes visible once its producer links it in, so pop() can briefly report empty while a push is halfway through (it's then seen next call)
+template <typename T>
+class MPSC_Queue
+{
+public:
+	MPSC_Queue() : head(&stub), tail(&stub)
+	{
+	}
+ 
+	~MPSC_Queue()
+	{
+		T discarded;
+		while (pop(discarded))
+			;
+		if (tail != &stub)
+			delete tail;
+	}
+ 
+	MPSC_Queue(const MPSC_Queue&) = delete;
+	MPSC_Queue& operator=(const MPSC_Queue&) = delete;
+ 
+	// Any thread.
+	void push(T value)
+	{
+		Node* node = new Node;
+		node->value = std::move(value);
+ 
+		Node* previous = head.exchange(node, std::memory_order_acq_rel); // Claims the producers' end... then links the previous node to it.
+		previous->next.store(node, std::memory_order_release);
+	}
+ 
+	// Consumer thread only... false when the queue is (currently) empty.
+	bool pop(T& value)
+	{
+		Node* next = tail->next.load(std::memory_order_acquire);
+		if (!next)
+			return false;
+ 
+		value = std::move(next->value); // "next" becomes the new (already consumed) front node.
+		if (tail != &stub)
+			delete tail;
+		tail = next;
+		return true;
+	}
+ 
+private:
+	struct Node
+	{
+		std::atomic<Node*> next{ nullptr };
+		T value;
+	};
+	Node stub; // The initial front node, so "head" & "tail" are never null.
+ 
+	std::atomic<Node*> head; // Producers' end (last pushed)
+	Node* tail; // Consumer's end: the front node, whose value has already been taken.
+};
@@ -3,7 +3,11 @@
 class Shader
 {
 public:
-	GLuint ID; // Public Program ID.
+	GLuint ID = 0; // Public Program ID.
+
+	Shader() // Empty... filled in later via: create_program(...) e.g. by the asset loader, once it has read the files on a worker thread.
+	{
+	}
 
 	// Constructor
 	// ---------------
@@ -50,6 +54,13 @@ public:
 		// std::cout << vert_string << "\n\n"; // Output the shader files to display in the console window.
 		// std::cout << frag_string << "\n\n";
 
+		create_program(vert_string, frag_string);
+	}
+
+	// Compiles & links the shader text (GL thread)
+	// ------------------------------------------------------
+	void create_program(const std::string& vert_string, const std::string& frag_string)
+	{
 		const char* vert_pointer = vert_string.c_str();
 		const char* frag_pointer = frag_string.c_str();
 
@@ -1,22 +1,87 @@
 #pragma once // https://docs.microsoft.com/en-us/windows/win32/gdi/raster--vector--truetype--and-opentype-fonts
  
+#if defined(_M_X64) || defined(__SSE2__) // SSE2 is always available on x64... used by the batch quad kernel: process_text_quads_sse(...)
+#include <emmintrin.h>
+#define TEXT_GLYPHS_SSE2
+#endif
+ 
 class Text
 {
+public:
+	enum class Text_Alignment { left, centre, right }; // Paragraph mode line alignment, within the paragraph's maximum width.
+ 
+	struct Text_Extent // Returned by: measure_text(...)... all in pixels.
+	{
+		int width = 0; // The widest line's pen advance.
+		int height = 0; // Top of the 1st line's ascender to the bottom of the last line's descender.
+ 
+		int ascender = 0; // Per line, from the font's size metrics (descender is negative, as in FreeType)
+		int descender = 0;
+		int line_height = 0; // Baseline to baseline, as paragraph lines are spaced.
+		unsigned line_count = 0;
+	};
+ 
+	struct Text_Span // Rich text: per-glyph attributes for the characters [first_character, end_character), as passed to: set_message_spans(...)
+	{
+		unsigned first_character = 0; // Byte offsets into the message (as with the caret queries)
+		unsigned end_character = 0;
+ 
+		glm::vec3 colour = glm::vec3(255.0f); // [0, 255] per channel, as with the "font_colour" uniform.
+		unsigned style = 0; // 0 = regular, 1 = bold (emboldened in the fragment shader)... 4 bits are stored.
+		bool shadow = false; // Drawn in the "shadowColor" uniform's colour.
+	};
+ 
+	struct Text_Rect // Returned by the caret & selection queries... window pixels, as with the text start positions (x rightwards, y downwards from the top-left)
+	{
+		float x = 0.0f;
+		float y = 0.0f;
+		float width = 0.0f;
+		float height = 0.0f;
+	};
+ 
 private:
-	struct Alphabet_Characters
+	struct Alphabet_Metrics // Structure-of-arrays glyph metrics table... each layout step reads only the packed array(s) it needs.
 	{
-		float left_bearing = 0.0f;
-		float bottom_bearing = 0.0f;
-		float height_plus_padding = 0.0f;
-		float width_plus_padding = 0.0f;
-		float glyph_advance_x = 0.0f;		
+		std::vector<char32_t> codepoint; // Each glyph's Unicode codepoint, in atlas order.
+ 
+		std::vector<float> glyph_advance_x;
+		std::vector<float> left_bearing;
+		std::vector<float> bottom_bearing;
+		std::vector<float> width_plus_padding;
+		std::vector<float> height_plus_padding;
+ 
+		std::vector<unsigned short> texcoord_rect; // 4 per glyph (left, bottom, right, top) as 16-bit normalised values, i.e. [0, 65535] = [0, 1]
  
-		char character;
+		std::vector<int> character_lookup = std::vector<int>(128, -1); // ASCII codepoint -> alphabet index, or -1 when not in the alphabet (read directly by the ASCII fast path)
+		std::unordered_map<char32_t, int> codepoint_lookup; // The same, for every non-ASCII codepoint in the alphabet.
  
-		glm::vec2 texcoord_top_left;
-		glm::vec2 texcoord_top_right;
-		glm::vec2 texcoord_bottom_left;
-		glm::vec2 texcoord_bottom_right;
+		int ascender = 0; // Pixels, from the primary face's size metrics... used by: measure_text(...)
+		int descender = 0;
+		int line_height = 0;
+ 
+		unsigned size() const
+		{
+			return (unsigned)codepoint.size();
+		}
+ 
+		int glyph_index(char32_t message_codepoint) const
+		{
+			if (message_codepoint < 128)
+				return character_lookup[message_codepoint];
+ 
+			std::unordered_map<char32_t, int>::const_iterator found = codepoint_lookup.find(message_codepoint);
+			return (found == codepoint_lookup.end()) ? -1 : found->second;
+		}
+ 
+		float texcoord(unsigned index, unsigned edge) const // Edge: 0 = left, 1 = bottom, 2 = right, 3 = top.
+		{
+			return texcoord_rect[index * 4 + edge] * (1.0f / 65535.0f);
+		}
+ 
+		void push_texcoord(float value)
+		{
+			texcoord_rect.push_back((unsigned short)(value * 65535.0f + 0.5f));
+		}
 	};
  
 	struct Message_Characters
@@ -30,9 +95,65 @@ private:
 		glm::vec4 bottom_right_tr2;
 	};
  
+	struct Alphabet_Upload // Async mode: rasterised on a worker thread, then streamed into the texture through the renderer, one budgeted slice per frame.
+	{
+		Job_System::Job_Handle rasterized; // Null once the job's result has been collected in: update_async_uploads()
+ 
+		std::vector<unsigned char> alphabet_pixels;
+		std::shared_ptr<const Alphabet_Metrics> alphabet_metrics;
+ 
+		int alphabet_texture_width = 0;
+		int alphabet_texture_height = 0;
+		int tallest_font_height = 0;
+		int relative_distance = 0;
+ 
+		unsigned alphabet_texture = 0;
+		unsigned staging_buffer = 0; // Renderer handle, created on the 1st streamed slice.
+		int rows_uploaded = 0;
+	};
+ 
+	struct Paragraph_Line // Paragraph mode: 1 line's break result, kept between edits so that lines unaffected by an edit (or width change) are reused as they are.
+	{
+		unsigned first_character = 0; // Range within "message_string", including the trailing space(s) or '\n' that ended the line.
+		unsigned end_character = 0;
+		unsigned decision_end = 0; // The break was decided by reading up to here (i.e. the end of the next word)... an edit before this point invalidates the line.
+ 
+		float width = 0.0f; // Excluding trailing spaces (layout pixels)
+		float next_width = 0.0f; // The width had the next word (or the next character of a split long word) been placed too... FLT_MAX after a '\n' or at the end.
+		float align_offset = 0.0f;
+ 
+		unsigned first_quad = 0;
+		unsigned quad_count = 0;
+	};
+ 
+	struct Glyph_Run // A static message's quads laid out once at pixel (0, 0)... every identical message (same string, font & size) draws this same vertex range at its own offset.
+	{
+		unsigned VAO_run = 0, VBO_run = 0;
+		unsigned quad_count = 0;
+ 
+		std::string message_string; // Compared on lookup, so a hash collision never shares the wrong geometry.
+		std::shared_ptr<const Alphabet_Metrics> alphabet_metrics; // The texture coordinates are only valid for this alphabet.
+ 
+		float text_start_x = 0.0f; // As laid out at pixel (0, 0)... each message adds its "run_offset"
+		float text_start_y = 0.0f;
+		std::vector<float> start_x_current; // Kept (unlike the quads) for the caret & hit-test queries.
+		std::vector<unsigned> quad_character;
+	};
+ 
+	struct Batch_Buffer // The quad buffer shared by a batch's static messages, see: create_text_messages(...)
+	{
+		unsigned VAO_batch = 0, VBO_batch = 0;
+	};
+ 
 	struct Message_Parent
 	{		
-		unsigned VAO_message, VBO_message, VAO_alphabet, VBO_alphabet;
+		// The per-glyph storage is allocated from the Text object's "message_arena"... Message_Parent is moved (never copied) into "messages" so it keeps that allocator.
+		explicit Message_Parent(std::pmr::memory_resource* message_arena = std::pmr::get_default_resource()) : message_string(message_arena), characters_quads(message_arena), start_x_current(message_arena), quad_character(message_arena)
+		{
+		}
+ 
+
+		unsigned VAO_message = 0, VBO_message = 0, VAO_alphabet = 0, VBO_alphabet = 0; // The alphabet's preview quad is only created for the message that created the alphabet.
 		unsigned alphabet_texture;
  
 		bool draw_alphabet = true;
@@ -47,545 +168,4098 @@ private:
 		int alphabet_texture_width = 0;
 		int alphabet_texture_height = 0;
  
-		float alphabet_start_x = -0.80f; // These are set here in OpenGL [-1, 1] coordinate range.
-		float alphabet_start_y = -0.45f;
+		float alphabet_start_x = 0.0f; // Layout pixels... set in: create_alphabet_image_quad(...)
+		float alphabet_start_y = 0.0f;
+		float glyph_pixel_scale = 1.0f; // Layout pixels per rasterised pixel (1 / the DPI scale the alphabet was rasterised at)... multiplies every glyph metric below.
  
 		float text_start_x = 0.0f;
 		float text_start_y = 0.0f;		
  
-		std::string message_string;
-		std::vector<Alphabet_Characters> alphabet_vec;
+		std::pmr::string message_string;
+		std::shared_ptr<const Alphabet_Metrics> alphabet_metrics; // Shared (read-only) by every message using this alphabet, rather than copied per message.
 		Message_Characters alphabet_quad;
  
-		std::vector<Message_Characters> characters_quads;
-		std::vector<float> start_x_current;
+		std::pmr::vector<Message_Characters> characters_quads;
+		std::pmr::vector<float> start_x_current;
+		std::pmr::vector<unsigned> quad_character; // Each quad's index into "message_string" (characters missing from the alphabet have no quad)... ascending within each line.
  
 		std::string font_path;
-	};
-	// --------------------------------	
-	std::string alphabet_string;	
+		std::vector<std::string> fallback_font_paths; // Ordered fallback chain (e.g. symbols, then CJK) searched when "font_path" lacks a codepoint.
  
-	FT_Library& free_type;
-	FT_GlyphSlot glyph; // "glyph" (FT_GlyphSlot) is simply being used as shorthand for "face" (FT_Face) ->glyph... set in: set_font_parameters()
+		std::u32string alphabet_characters; // The codepoints packed into this alphabet, in atlas order (defaults to the Text object's "alphabet_string", decoded)
+		std::vector<unsigned char> alphabet_pixels; // CPU copy of the alphabet image... filled in: format_alphabet_texture_image() and freed once uploaded.
  
-	float scale_pixels_x_to_OpenGL = 0.0f; // OpenGL [-1, 1] (i.e. 2) divided by the number of screen pixels.
-	float scale_pixels_y_to_OpenGL = 0.0f;
-	
-	int character_row_limit = 15; // Alphabet character row limit.
-	int alphabet_padding = 7; // Padding is optional (it spaces out the alphabet characters, without affecting each message's character spacing)
-	// Note: if character background is slightly opaque e.g. 0.1 = vec4(1, 1, 1, texture(text_Texture, texture_coordinates).r) + 0.1, then spaces, i.e. simply " " show as a: alphabet_padding * alphabet_padding square.
+		bool paragraph = false; // Paragraph mode (multi-line)... set in: create_paragraph_message(...)
+		float paragraph_max_width = 0.0f;
+		Text_Alignment paragraph_alignment = Text_Alignment::left;
+		std::vector<Paragraph_Line> lines;
  
-public:
-	FT_Face face; // Resources are freed in main() via FT_Done_Face(...)
+		bool glyphs_pending = false; // Async mode: placeholder boxes are drawn until the alphabet has finished uploading.
+		int requested_start_x = 0; // The pixel start position passed to: create_text_message_async(...) or create_paragraph_message(...), kept for later layouts.
+		int requested_start_y = 0;
+		std::shared_ptr<Alphabet_Upload> alphabet_upload; // Shared by every pending message waiting on the same font path & size.
  
-	std::vector<Message_Parent> messages;
+		std::shared_ptr<const Glyph_Run> glyph_run; // Set for static messages drawn from "glyph_run_cache" (their own "characters_quads" then stay empty)
+		glm::vec2 run_offset = glm::vec2(0.0f); // The message's start position... passed to the vertex shader's "message_offset" uniform.
  
-	Text(FT_Library& free_type, int window_width, int window_height, std::string alphabet_string) : free_type(free_type)
+		std::shared_ptr<Batch_Buffer> batch_buffer; // Created via: create_text_messages(...)... "VAO_message" & "VBO_message" are shared by the whole batch (static), and freed with its last message.
+		unsigned buffer_first_quad = 0; // The message's 1st quad within that shared buffer.
+ 
+		std::vector<Text_Span> spans; // Rich text... set via: set_message_spans(...)
+		unsigned VBO_attributes = 0; // 1 packed unsigned per vertex (vertex attribute 1)... created with the first spans.
+ 
+		unsigned numeric_capacity = 0; // Numeric-field mode: the fixed number of glyph slots (0 = not a numeric field)... "message_string" then holds each slot's character ('\0' = blank)
+ 
+		bool removed = false; // Set via: remove_message(...)... no longer drawn, but still holds its alphabet (its index may be reused, see: store_message(...))
+		bool slot_free = false; // Removed, and on "free_message_slots"... otherwise a removed entry is kept, as the last holder of its alphabet.
+	};
+ 
+	struct Immediate_Text // 1 draw_text(...) call queued for this frame.
 	{
-		this->alphabet_string = alphabet_string;		
-		scale_pixels_x_to_OpenGL = 2.0f / window_width; // Scale vertex data to render on-screen the same size as the font's set pixel-size... 
-		scale_pixels_y_to_OpenGL = 2.0f / window_height; // This makes the text display at the same correct pixel size, regardless of the window size.
-	}
+		unsigned alphabet_texture = 0;
+		unsigned first_quad = 0; // Into "Immediate_Frame::quads"
+		unsigned quad_count = 0;
+	};
  
-	void create_text_message(std::string message, int text_start_x, int text_start_y, std::string font_path, int font_size, bool dynamic_static)
+	struct Immediate_Frame // Everything queued via draw_text(...) lives in "arena", which is reset (not freed) once the frame is drawn.
 	{
-		int alphabet_detected = -1;
-		for (int i = 0; i < messages.size(); ++i)
+		explicit Immediate_Frame(size_t arena_bytes) : arena_buffer(arena_bytes), arena(arena_buffer.data(), arena_buffer.size()), texts(&arena), quads(&arena)
 		{
-			if (messages[i].font_size == font_size && messages[i].font_path == font_path)
-			{
-				alphabet_detected = i;				
-				break;
-			}			
-		}			
-		Message_Parent new_message; // Changed by reference during most of the below function calls.
+		}
  
-		new_message.font_size = font_size;
-		new_message.font_path = font_path;		
-		
-		if (alphabet_detected == -1) // Create new alphabet.
+		std::vector<std::byte> arena_buffer;
+		std::pmr::monotonic_buffer_resource arena; // Falls back to the heap if a frame outgrows "arena_buffer" (which then grows for the next frame)
+ 
+		std::pmr::vector<Immediate_Text> texts;
+		std::pmr::vector<Message_Characters> quads;
+	};
+ 
+	struct Document_Chunk // Virtualized documents: 1 recyclable GPU buffer, holding the quads of "document_chunk_lines" consecutive lines.
+	{
+		int chunk_index = -1; // The chunk currently held (-1 = free for reuse)
+		unsigned VAO_chunk = 0, VBO_chunk = 0;
+		size_t allocated_memory_bytes = 0;
+		unsigned quad_count = 0;
+	};
+ 
+	struct Document // Virtualized documents: only the chunks of lines within the view are laid out & uploaded... see: create_document(...)
+	{
+		std::string text;
+		std::vector<unsigned> line_starts; // Byte offset of each line (the only per-line data kept for the whole document)
+ 
+		int view_x = 0; // The view rectangle (window pixels)... text outside it is clipped.
+		int view_y = 0;
+		int view_width = 0;
+		int view_height = 0;
+		float scroll_y = 0.0f; // Pixels scrolled down from the document's top.
+ 
+		unsigned max_line_glyphs = 0; // The most glyphs of 1 line that can fit across the view... longer lines are cut there.
+ 
+		Message_Parent layout; // Holds the alphabet... its vectors are reused as scratch space whenever a chunk is laid out.
+		std::vector<Document_Chunk> chunks; // Slot pool... grows only to the number of chunks visible at once.
+	};
+ 
+	struct Log_Line
+	{
+		unsigned long long serial = 0; // Appended line number (never reused)
+		unsigned first_quad = 0; // Within the log's ring of quads.
+		unsigned quad_count = 0;
+	};
+ 
+	struct Text_Log // Append-only log (chat, combat): a fixed ring of glyph quads... see: create_log(...)
+	{
+		int log_x = 0; // Top-left of the newest screenful (window pixels)
+		int log_y = 0;
+		unsigned visible_rows = 0;
+		unsigned scroll_rows = 0; // Rows scrolled back from the newest line.
+ 
+		unsigned capacity_quads = 0;
+		unsigned write_quad = 0; // Where the next line's quads go (wraps to 0 when a line won't fit before the end)
+ 
+		std::vector<Log_Line> lines; // Ring of line records, fixed at "max_lines"
+		unsigned oldest_line = 0; // Index into "lines"
+		unsigned line_count = 0;
+		unsigned long long next_serial = 0;
+ 
+		unsigned VAO_log = 0, VBO_log = 0; // Allocated once, at "capacity_quads"
+		Message_Parent layout; // Holds the alphabet... its vectors are reused as scratch space for each appended line.
+	};
+ 
+	struct Terminal_Grid // Monospace grid: 1 integer texel per cell, drawn as a single quad whose fragment shader looks each pixel's glyph up in the atlas... see: create_terminal_grid(...)
+	{
+		int grid_x = 0; // Top-left (window pixels)
+		int grid_y = 0;
+		unsigned columns = 0;
+		unsigned rows = 0;
+		int cell_width = 0; // Pixels.
+		int cell_height = 0;
+ 
+		std::vector<unsigned> cells; // CPU copy of "cell_texture" (row 0 = the top row)
+		unsigned cell_texture = 0; // 1 unsigned per cell... bits 0-15 = glyph index + 1 (0 = empty), bits 16-31 = RGB565 colour.
+		unsigned glyph_table_texture = 0; // 4 x 16-bit signed per texel, 1 column per glyph... row 0 = atlas rectangle, row 1 = its offset within a cell.
+		unsigned VAO_grid = 0, VBO_grid = 0;
+ 
+		Message_Parent layout; // Holds the alphabet.
+	};
+ 
+	struct Bundle_String // 1 string loaded via: load_text_bundle(...)
+	{
+		std::shared_ptr<const Glyph_Run> run;
+		unsigned alphabet_message = 0; // Index of the bundle alphabet's alphabet-only entry in "messages"
+	};
+ 
+	struct Mapped_File // Read-only memory mapping of a whole file (unmapped when destroyed)... used by: load_text_bundle(...)
+	{
+		const char* data = nullptr;
+		size_t size = 0;
+ 
+		explicit Mapped_File(const std::string& path)
 		{
-			//std::cout << "\n\n   New alphabet created (characters are listed below) --- Font path: " << font_path << " --- Font size: " << font_size;
+#ifdef _WIN32
+			file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+			LARGE_INTEGER file_size{};
+			if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)
+				return;
  
-			set_font_parameters(new_message);
-			create_blank_texture(new_message);
-			calculate_alphabet_image_size(new_message);
-			format_alphabet_texture_image(new_message);
-			create_alphabet_image_quad(new_message);
-			set_buffer_data_alphabet(new_message);
+			mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+			if (mapping)
+				data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			if (data)
+				size = (size_t)file_size.QuadPart;
+#else
+			int file = open(path.c_str(), O_RDONLY);
+			struct stat file_stat {};
+			if (file != -1 && fstat(file, &file_stat) == 0 && file_stat.st_size > 0)
+			{
+				void* view = mmap(nullptr, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+				if (view != MAP_FAILED)
+				{
+					data = (const char*)view;
+					size = (size_t)file_stat.st_size;
+				}
+			}
+			if (file != -1)
+				close(file); // The mapping stays valid.
+#endif
 		}
-		else // Copy the existing alphabet.
+ 
+		~Mapped_File()
 		{
-			new_message.draw_alphabet = false;
-			new_message.alphabet_vec = messages[alphabet_detected].alphabet_vec;
-			new_message.alphabet_texture = messages[alphabet_detected].alphabet_texture;
-			new_message.alphabet_texture_width = messages[alphabet_detected].alphabet_texture_width;
-			new_message.alphabet_texture_height = messages[alphabet_detected].alphabet_texture_height;
-			new_message.tallest_font_height = messages[alphabet_detected].tallest_font_height;
-			new_message.relative_distance = messages[alphabet_detected].relative_distance;
-			
-			//std::cout << "\n\n   Existing alphabet detected (no new alphabet is required) --- Font path: " << font_path << " --- Font size: " << font_size << "\n";
+#ifdef _WIN32
+			if (data)
+				UnmapViewOfFile(data);
+			if (mapping)
+				CloseHandle(mapping);
+			if (file != INVALID_HANDLE_VALUE)
+				CloseHandle(file);
+#else
+			if (data)
+				munmap((void*)data, size);
+#endif
 		}
-		new_message.message_string = message;
-		process_text_compare(new_message, text_start_x, text_start_y); // process_text_index(...) is called within this function call.
  
-		new_message.dynamic_static = dynamic_static; // True = dynamic.
-		initialise_buffer_data_message(new_message); // Initialise the message's buffer data.
-		update_buffer_data_message(new_message, 0); // Update the message's buffer data.
+		Mapped_File(const Mapped_File&) = delete;
+		Mapped_File& operator=(const Mapped_File&) = delete;
  
-		messages.push_back(new_message); // Add the new message to the list of messages.
-	}
+#ifdef _WIN32
+	private:
+		HANDLE file = INVALID_HANDLE_VALUE;
+		HANDLE mapping = NULL;
+#endif
+	};
  
-	void draw_alphabets()
+	struct Bundle_Reader // Bounds-checked cursor over a mapped bundle... once a read runs past the end, "valid" stays false and every later read returns nothing.
 	{
-		for (unsigned i = 0; i < messages.size(); ++i)
+		const char* data = nullptr;
+		size_t size = 0;
+		size_t offset = 0;
+		bool valid = true;
+ 
+		const char* bytes(size_t count)
 		{
-			if (messages[i].draw_alphabet)
+			if (!valid || count > size - offset)
 			{
-				glBindVertexArray(messages[i].VAO_alphabet);
- 
-				glActiveTexture(GL_TEXTURE31);
-				glBindTexture(GL_TEXTURE_2D, messages[i].alphabet_texture);
- 
-				glDisable(GL_DEPTH_TEST);
-				glDrawArrays(GL_TRIANGLES, 0, 6);
-				glEnable(GL_DEPTH_TEST);
- 
-				glActiveTexture(GL_TEXTURE0);
-				glBindVertexArray(0);
-				// std::cout << "\n   Drawing alphabet... messages index: " << i;
+				valid = false;
+				return nullptr;
 			}
+			const char* position = data + offset;
+			offset += count;
+			return position;
 		}
-	}
  
-	void draw_messages()
-	{
-		for (unsigned i = 0; i < messages.size(); ++i)
+		template <typename T>
+		T value()
 		{
-			glBindVertexArray(messages[i].VAO_message);
-			
-			glActiveTexture(GL_TEXTURE31);
-			glBindTexture(GL_TEXTURE_2D, messages[i].alphabet_texture);
- 
-			glDisable(GL_DEPTH_TEST); // Cast (unsigned) used below, silences the compiler warning (unsigned 32 bit is still over 4 billion)
-			glDrawArrays(GL_TRIANGLES, 0, (unsigned)messages[i].characters_quads.size() * 6);
-			glEnable(GL_DEPTH_TEST);
- 
-			glActiveTexture(GL_TEXTURE0);
-			glBindVertexArray(0);
+			T result{};
+			const char* position = bytes(sizeof(T));
+			if (position)
+				memcpy(&result, position, sizeof(T));
+			return result;
 		}
-	}
  
-	void draw_messages(unsigned message_index)
-	{		
-		if (message_index > messages.size() - 1)
+		template <typename T>
+		const char* array(size_t count) // Unaligned... copy out, or hand straight to GL.
 		{
-			std::cout << "\n   Warning: draw_messages(...) --- 'message_index' is greater than 'messages.size() - 1'\n";
+			if (count > size / sizeof(T))
+			{
+				valid = false;
+				return nullptr;
+			}
+			return bytes(count * sizeof(T));
+		}
  
-			int keep_console_open;			
-			std::cin >> keep_console_open;
+		template <typename T, typename Container>
+		void copy_array(Container& values, size_t count)
+		{
+			const char* position = array<T>(count);
+			values.resize(position ? count : 0);
+			if (position && count > 0)
+				memcpy(&values[0], position, count * sizeof(T));
 		}
-		else
+ 
+		std::string string()
 		{
-			glBindVertexArray(messages[message_index].VAO_message);
+			unsigned length = value<unsigned>();
+			const char* position = bytes(length);
+			return position ? std::string(position, length) : std::string();
+		}
+	};
+ 
+	struct Measure_Font // 1 per font path & size measured... the per-character advances are all measure_text(...) reads.
+	{
+		std::string font_path;
+		int font_size = 0;
+		bool from_alphabet = false; // False = from the fallback chain's glyph metrics (no alphabet existed yet)... replaced by the alphabet's values once it's created.
+		float alphabet_scale = 0.0f; // The alphabet's "glyph_pixel_scale"... a DPI change re-registers the re-rasterised alphabet.
  
-			glActiveTexture(GL_TEXTURE31);
-			glBindTexture(GL_TEXTURE_2D, messages[message_index].alphabet_texture);
+		int advance[128] = {}; // Pixels, per ASCII codepoint... 0 for characters missing from the alphabet, which layout skips.
+		std::vector<std::pair<char32_t, int>> extended_advance; // Non-ASCII (codepoint, advance) pairs, sorted for a binary search.
  
-			glDisable(GL_DEPTH_TEST); // Cast (unsigned) used below, silences the compiler warning (unsigned 32 bit is still over 4 billion)
-			glDrawArrays(GL_TRIANGLES, 0, (unsigned)messages[message_index].characters_quads.size() * 6);
-			glEnable(GL_DEPTH_TEST);
+		int advance_of(char32_t codepoint) const
+		{
+			if (codepoint < 128)
+				return advance[codepoint];
  
-			glActiveTexture(GL_TEXTURE0);
-			glBindVertexArray(0);
+			auto found = std::lower_bound(extended_advance.begin(), extended_advance.end(), std::make_pair(codepoint, INT_MIN));
+			return (found != extended_advance.end() && found->first == codepoint) ? found->second : 0;
 		}
-	}
+		int ascender = 0;
+		int descender = 0;
+		int line_height = 0;
+	};
  
-	void process_text_index(Message_Parent& new_message, unsigned index, float advanced_current)
-	{		
-		// Y-Values (by default the characters are bottom aligned) ("new_message.text_start_x & text_start_y"  are set in: process_text_compare(...))
-		// ---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-		float bottom_bearing = new_message.alphabet_vec[index].bottom_bearing;
-		float y_pos_aligned = new_message.text_start_y - bottom_bearing;
-		float height = new_message.alphabet_vec[index].height_plus_padding;
+	struct Measure_Memo // Direct-mapped cache entry, for repeated short strings.
+	{
+		const Measure_Font* font = nullptr;
+		size_t hash = 0;
+		unsigned length = 0;
+		char text[32] = {};
+		Text_Extent extent;
+	};
  
-		float texcoord_top_left_y = new_message.alphabet_vec[index].texcoord_top_left.y;
-		float texcoord_bottom_right_y = new_message.alphabet_vec[index].texcoord_bottom_right.y;
-		float texcoord_top_right_y = new_message.alphabet_vec[index].texcoord_top_right.y;
-		float texcoord_bottom_left_y = new_message.alphabet_vec[index].texcoord_bottom_left.y;
+	struct Glyph_Source
+	{
+		int face_index = 0; // Index into "Face_Chain::faces"... 0 = the primary face.
+		FT_UInt glyph_index = 0; // 0 = the primary face's missing glyph (.notdef) when no face in the chain has the codepoint.
+	};
  
-		// X-Values
-		// -----------		
-		float start_x_current = new_message.text_start_x + advanced_current;
-		float left_bearing = new_message.alphabet_vec[index].left_bearing;
-		float width = new_message.alphabet_vec[index].width_plus_padding;
+	struct Face_Chain // The faces used while rasterising one alphabet (each async worker opens its own private chain)
+	{
+		std::vector<FT_Face> faces; // Primary face followed by the fallback faces.
+		std::string key; // Identifies the chain within "fallback_cache"
+		FT_GlyphSlot glyph = nullptr; // "glyph" (FT_GlyphSlot) is simply being used as shorthand for "face" (FT_Face) ->glyph... set in: load_alphabet_glyph()
+		bool private_faces = false; // True = opened for a worker thread, and closed again via: close_face_chain()
+	};
+	// --------------------------------	
+	std::string alphabet_string; // UTF-8
+	std::u32string alphabet_codepoints; // "alphabet_string" decoded... every alphabet's default character set.
+	std::vector<std::string> fallback_font_paths; // Set in: set_fallback_fonts(...)
  
-		float texcoord_bottom_left_x = new_message.alphabet_vec[index].texcoord_bottom_left.x;
-		float texcoord_bottom_right_x = new_message.alphabet_vec[index].texcoord_bottom_right.x;
-		float texcoord_top_left_x = new_message.alphabet_vec[index].texcoord_top_left.x;
-		float texcoord_top_right_x = new_message.alphabet_vec[index].texcoord_top_right.x;
+	Text_Renderer& renderer; // Every GPU resource & draw goes through this (see: "text_renderer.h")... the rest of Text is CPU-only.
+	FT_Library& free_type;
+	std::mutex free_type_mutex; // FT_New_Face(...) & FT_Done_Face(...) are not thread-safe on a shared FT_Library.
  
-		Message_Characters quad{};
+	// Codepoint -> face decisions, stored per fallback chain (glyph indices do not depend on the pixel size, so all font sizes share one cache)
+	std::map<std::string, std::unordered_map<unsigned long, Glyph_Source>> fallback_cache;
+	std::mutex fallback_cache_mutex;
  
-		// Triangle 1
-		// -------------
-		quad.bottom_left_tr1.x = start_x_current + left_bearing;
+	unsigned placeholder_texture = 0; // 1x1 faint texel sampled by the placeholder boxes of async messages (created on first use)
  
-		// Used for replacing characters from some index position, to the end of the full message length
-		// ---------------------------------------------------------------------------------------------------------------------------
-		new_message.start_x_current.push_back(start_x_current); // Record the character's start position... but excluding: left_bearing	
+	struct Glyph_Usage // Recorded per (font path, font size), i.e. per alphabet.
+	{
+		std::map<unsigned long, unsigned> codepoint_counts; // Codepoint -> number of times laid out.
+		std::map<std::pair<unsigned long, unsigned long>, unsigned> co_occurrence; // (smaller, larger) codepoint pair -> number of messages using both.
+	};
+	bool record_glyph_usage = false; // Set via: start_usage_recording()
+	std::map<std::pair<std::string, int>, Glyph_Usage> glyph_usage;
+	std::mutex glyph_usage_mutex; // Messages can be laid out on several threads at once, via: create_text_messages_parallel(...)
  
-		quad.bottom_left_tr1.y = y_pos_aligned;
-		quad.bottom_left_tr1.z = texcoord_bottom_left_x;
-		quad.bottom_left_tr1.w = texcoord_top_left_y; // Y-axis texture coordinates are reversed.
  
-		quad.bottom_right_tr1.x = start_x_current + left_bearing + width;
-		quad.bottom_right_tr1.y = y_pos_aligned;
-		quad.bottom_right_tr1.z = texcoord_bottom_right_x;
-		quad.bottom_right_tr1.w = texcoord_top_right_y;
+	struct Alphabet_Rescale // 1 alphabet being re-rasterised for a new DPI scale (its messages keep drawing the old one meanwhile)... see: set_dpi_scale(...)
+	{
+		Message_Parent settings; // Font path & size, fallbacks, characters & the new "glyph_pixel_scale".
+		std::shared_ptr<const Alphabet_Metrics> old_metrics; // Identifies everything laid out against the old alphabet.
+		unsigned old_texture = 0;
+		float old_glyph_pixel_scale = 1.0f;
+		std::shared_ptr<Alphabet_Upload> upload;
+	};
+	std::vector<Alphabet_Rescale> alphabet_rescales;
  
-		quad.top_left_tr1.x = start_x_current + left_bearing;
-		quad.top_left_tr1.y = y_pos_aligned + height;
-		quad.top_left_tr1.z = texcoord_top_left_x;
-		quad.top_left_tr1.w = texcoord_bottom_left_y;
+	// Text commands... see: apply_text_commands()
+	enum class Text_Command_Type { create, set_text, remove };
+	struct Text_Command // Submitted from any thread via the submit_*(...) functions.
+	{
+		Text_Command_Type type = Text_Command_Type::create;
+		unsigned handle = 0;
  
-		// Triangle 2
-		// -------------
-		quad.top_left_tr2.x = start_x_current + left_bearing;
-		quad.top_left_tr2.y = y_pos_aligned + height;
-		quad.top_left_tr2.z = texcoord_top_left_x;
-		quad.top_left_tr2.w = texcoord_bottom_left_y;
+		std::string text; // create & set_text.
+		int text_start_x = 0; // create only.
+		int text_start_y = 0;
+		std::string font_path;
+		int font_size = 10;
+		bool dynamic_static = false;
+	};
+	MPSC_Queue<Text_Command> text_commands;
+	std::atomic<unsigned> next_message_handle{ 0 };
+	std::vector<unsigned> handle_messages; // Render thread only: handle -> index into "messages" (UINT_MAX = removed, or not yet applied)
+	std::vector<Text_Command> applied_commands; // Render thread only: 1 frame's drained commands (capacity is kept between frames)
+	std::unordered_map<unsigned, size_t> last_handle_command; // Render thread only: handle -> its last command this frame.
  
-		quad.top_right_tr2.x = start_x_current + left_bearing + width;
-		quad.top_right_tr2.y = y_pos_aligned + height;
-		quad.top_right_tr2.z = texcoord_top_right_x;
-		quad.top_right_tr2.w = texcoord_bottom_right_y;
+	std::unordered_map<size_t, std::shared_ptr<const Glyph_Run>> glyph_run_cache; // Key: glyph_run_key(...)... static messages only, as dynamic messages are edited in place.
  
-		quad.bottom_right_tr2.x = start_x_current + left_bearing + width;
-		quad.bottom_right_tr2.y = y_pos_aligned;
-		quad.bottom_right_tr2.z = texcoord_bottom_right_x;
-		quad.bottom_right_tr2.w = texcoord_top_right_y;
-		// --------------------------------------------------------------
-		// std::cout << "\n   CHARACTER: " << new_message.message_string.c_str()[index] << " --- start_x_current: " << start_x_current << " --- y_pos_aligned: " << y_pos_aligned << " --- width: " << width << " --- height: " << height;
-		// std::cout << "\n  texcoord_top_left_x: " << texcoord_top_left_x;
-		// std::cout << "\n   texcoord_top_right_x: " << texcoord_top_right_x << "\n";
+	// Measurement... see: measure_text(...)
+	std::deque<Measure_Font> measure_fonts; // Deque, so the "Measure_Memo::font" pointers stay valid as fonts are added.
+	std::vector<std::string> measure_fallback_font_paths; // "fallback_font_paths", as read by measure_text(...) from any thread.
+	Measure_Memo measure_memo[64];
+	std::mutex measure_mutex; // measure_text(...) may be called from any thread.
  
-		new_message.characters_quads.push_back(quad);		
-	}	
+	std::vector<Document> documents; // See: create_document(...)
+	std::vector<Terminal_Grid> terminal_grids; // See: create_terminal_grid(...)
+	std::vector<Text_Log> logs; // See: create_log(...)
+	std::vector<Bundle_String> bundle_strings; // See: load_text_bundle(...)
+	unsigned log_wrap_lines = 1024; // Log lines are laid out at row (serial % log_wrap_lines), so their coordinates stay small however long the log runs.
+	unsigned document_chunk_lines = 64;
  
-	void update_buffer_data_message(Message_Parent& new_message, int characters_offset)
-	{
-		glBindVertexArray(new_message.VAO_message);
-		glBindBuffer(GL_ARRAY_BUFFER, new_message.VBO_message);
+	// Immediate mode... see: draw_text(...)
+	std::vector<Message_Parent> immediate_layouts; // 1 per font path & size, holding the alphabet (its quads are reused as layout scratch space each call)
+	std::unique_ptr<Immediate_Frame> immediate_frame; // Created on first use.
+	unsigned VAO_immediate = 0, VBO_immediate = 0; // Streaming buffer... orphaned and refilled once per frame.
+	size_t immediate_buffer_bytes = 0;
  
-		GLintptr data_offset_bytes = (GLintptr)characters_offset * 6 * 4 * sizeof(float);
-		GLsizeiptr replace_size_bytes = (new_message.characters_quads.size() * 6 * 4 * sizeof(float)) - data_offset_bytes;
+	// Pooled memory for every message's string, quads & start positions (synchronized, as messages may be laid out on worker threads)
+	std::pmr::synchronized_pool_resource message_arena;
  
-		if (data_offset_bytes + replace_size_bytes > (unsigned)new_message.allocated_memory_bytes)
-		{			
-			std::cout << "\n   Warning: update_buffer_data_message(...) --- 'data_offset_bytes' " << data_offset_bytes << " + 'replace_size_bytes' " << replace_size_bytes << " was too large for 'allocated_memory_bytes' "
-				<< new_message.allocated_memory_bytes << " --- so 'replace_size_bytes' has been reduced to: ";
+	// Layout is in pixels (x rightwards, y upwards from the window's top edge, so on-screen text has negative y)... the vertex shader's "projection" maps it to clip space [-1, 1]
+	// so resizing the window is only a uniform update. The DPI scale only changes how large the glyphs are rasterised, see: set_dpi_scale(...)
+	int window_width = 0; // Framebuffer pixels.
+	int window_height = 0;
+	float dpi_scale = 1.0f; // Framebuffer pixels per layout pixel (e.g. from glfwGetWindowContentScale(...))
+	glm::mat4 projection = glm::mat4(1.0f);
+	
+	int character_row_limit = 15; // Alphabet character row limit.
+	int alphabet_padding = 7; // Padding is optional (it spaces out the alphabet characters, without affecting each message's character spacing)
+	// Note: if character background is slightly opaque e.g. 0.1 = vec4(1, 1, 1, texture(text_Texture, texture_coordinates).r) + 0.1, then spaces, i.e. simply " " show as a: alphabet_padding * alphabet_padding square.
  
-			replace_size_bytes -= (data_offset_bytes + replace_size_bytes) - new_message.allocated_memory_bytes;
-			std::cout << replace_size_bytes;
-		}
-		if (data_offset_bytes + replace_size_bytes < (unsigned)new_message.allocated_memory_bytes)
-		{
-			std::cout << "\n   Warning: update_buffer_data_message(...) --- 'data_offset_bytes' " << data_offset_bytes << " + 'replace_size_bytes' " << replace_size_bytes << " is less than 'allocated_memory_bytes' "
-				<< new_message.allocated_memory_bytes << " --- so 'characters_offset' " << characters_offset << " has been reduced to: ";
+public:
+	FT_Face face = nullptr; // Resources are freed in main() via FT_Done_Face(...)... alphabets rasterised as jobs use private faces instead, see: submit_alphabet_job(...)
+	std::map<std::string, FT_Face> fallback_faces; // Opened once per font path and shared by every alphabet... also freed in main() via FT_Done_Face(...)
  
-			characters_offset -= (int)((new_message.allocated_memory_bytes - (data_offset_bytes + replace_size_bytes)) / 6 / 4 / sizeof(float));
-			std::cout << characters_offset;
-		}
-		int keep_console_open;
-		if (characters_offset == -1)
-			std::cin >> keep_console_open;
+	std::vector<Message_Parent> messages;
+	std::vector<unsigned> free_message_slots; // Removed messages' indices, reused by the next messages created... see: remove_message(...)
  
-		glBufferSubData(GL_ARRAY_BUFFER, data_offset_bytes, replace_size_bytes, &new_message.characters_quads[characters_offset]);
-		glBindVertexArray(0);
-	}
+	size_t atlas_upload_budget_bytes = 64 * 1024; // Async mode: the most alphabet texture data streamed per frame (at least 1 texture row is always sent)
  
-private:
-	void set_font_parameters(Message_Parent new_message)
-	{	
-		FT_Error error_code{};
-		int keep_console_open;
-		
-		error_code = FT_New_Face(free_type, new_message.font_path.c_str(), 0, &face);
-		if (error_code)
-		{
-			std::cout << "\n\n   Error code: " << error_code << " --- " << "Could not open font: " << new_message.font_path.c_str();
-			std::cin >> keep_console_open;
-		}
-		error_code = FT_Set_Pixel_Sizes(face, 0, new_message.font_size);
-		if (error_code)
+	// "renderer" must outlive the Text object: e.g. Text_Renderer_GL (text_renderer_gl.h), or Text_Renderer_Headless to run the text core without a window.
+	Text(Text_Renderer& renderer, FT_Library& free_type, int window_width, int window_height, std::string alphabet_string) : renderer(renderer), free_type(free_type)
+	{
+		this->alphabet_string = alphabet_string;		
+ 
+		for (size_t i = 0; i < alphabet_string.size();)
 		{
-			std::cout << "\n\n   Error code: " << error_code << " --- " << "Could not set font pixel size : " << new_message.font_size;
-			std::cin >> keep_console_open;
+			char32_t codepoint = decode_utf8(alphabet_string.data(), alphabet_string.size(), i);
+			if (alphabet_codepoints.find(codepoint) == std::u32string::npos)
+				alphabet_codepoints += codepoint;
 		}
-		glyph = face->glyph; // Shorthand for "face->glyph"
-}
+		set_window_size(window_width, window_height);
+	}
  
-	void create_blank_texture(Message_Parent& new_message)
+	// Call when the framebuffer is resized, then pass the new "projection" to each text shader program via: upload_projection(...)... nothing is laid out again.
+	void set_window_size(int window_width, int window_height)
 	{
-		glGenTextures(1, &new_message.alphabet_texture);
-		glActiveTexture(GL_TEXTURE31);
-		glBindTexture(GL_TEXTURE_2D, new_message.alphabet_texture);
- 
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
- 
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST); // GL_NEAREST... GL_LINEAR
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
- 
-		glActiveTexture(GL_TEXTURE0);
+		this->window_width = window_width;
+		this->window_height = window_height;
+		projection = glm::ortho(0.0f, window_width / dpi_scale, -window_height / dpi_scale, 0.0f);
 	}
  
-	void calculate_alphabet_image_size(Message_Parent& new_message)
+	// Call when the window moves to a monitor with a different content scale... existing alphabets are re-rasterised in the background (through the same path as
+	// async mode) and swapped in once uploaded, so text keeps its layout-pixel size throughout and only becomes sharper (or softer)
+	void set_dpi_scale(float new_dpi_scale)
+	{
+		if (new_dpi_scale <= 0.0f || new_dpi_scale == dpi_scale)
+			return;
+ 
+		dpi_scale = new_dpi_scale;
+		set_window_size(window_width, window_height);
+ 
+		auto queue_rescale = [this](const Message_Parent& message)
+			{
+				if (!message.alphabet_metrics || message.glyph_pixel_scale == 1.0f / dpi_scale)
+					return;
+ 
+				for (const Alphabet_Rescale& rescale : alphabet_rescales)
+					if (rescale.old_metrics == message.alphabet_metrics)
+						return; // Already re-rasterising... restarted at the newest scale when it completes.
+ 
+				Alphabet_Rescale rescale;
+				rescale.settings.font_size = message.font_size;
+				rescale.settings.font_path = message.font_path;
+				rescale.settings.fallback_font_paths = message.fallback_font_paths;
+				rescale.settings.alphabet_characters = message.alphabet_characters;
+				rescale.settings.glyph_pixel_scale = 1.0f / dpi_scale;
+				rescale.old_metrics = message.alphabet_metrics;
+				rescale.old_texture = message.alphabet_texture;
+				rescale.old_glyph_pixel_scale = message.glyph_pixel_scale;
+				rescale.upload = start_alphabet_rasterisation(rescale.settings);
+ 
+				alphabet_rescales.push_back(std::move(rescale));
+			};
+		for (const Message_Parent& message : messages)
+			if (!message.glyphs_pending)
+				queue_rescale(message);
+ 
+		for (const Document& document : documents)
+			queue_rescale(document.layout);
+ 
+		for (const Message_Parent& layout : immediate_layouts)
+			queue_rescale(layout);
+	}
+ 
+	void upload_projection(unsigned shader_program) const
+	{
+		renderer.set_projection(shader_program, projection);
+	}
+ 
+	// The job system every alphabet & layout job runs on (shared with e.g. the asset loader, rather than oversubscribing the cores with a 2nd set of workers)
+	// Created on first use (render thread)... the calling thread helps while waiting, so it has 1 worker fewer than the core count.
+	Job_System& jobs()
+	{
+		if (!job_system)
+		{
+			unsigned core_count = std::thread::hardware_concurrency();
+			job_system.reset(new Job_System((core_count > 1) ? core_count - 1 : 1));
+		}
+		return *job_system;
+	}
+ 
+	// Fallback faces are searched in order for any alphabet character missing from a message's "font_path"... applies to alphabets created afterwards.
+	void set_fallback_fonts(std::vector<std::string> fallback_font_paths)
+	{
+		this->fallback_font_paths = fallback_font_paths;
+ 
+		std::lock_guard<std::mutex> measure_lock(measure_mutex);
+		measure_fallback_font_paths = fallback_font_paths;
+	}
+ 
+	// Usage profile: records which (font path, font size, character) glyphs are laid out, how often, and which are used together
+	// -----------------------------------------------------------------------------------------------------------------------------------------------------------
+	void start_usage_recording()
+	{
+		record_glyph_usage = true;
+	}
+ 
+	void stop_usage_recording()
+	{
+		record_glyph_usage = false;
+	}
+ 
+	// Compact binary layout... "GUP1", alphabet count, then per alphabet: path length, path, font size, glyph count, then (codepoint, count) pairs in atlas order.
+	void save_usage_profile(std::string profile_path)
+	{
+		std::ofstream profile(profile_path, std::ios::binary);
+		if (!profile.is_open())
+		{
+			std::cout << "\n   Warning: save_usage_profile(...) --- could not open: " << profile_path << "\n";
+			return;
+		}
+		profile.write("GUP1", 4);
+		write_profile_value(profile, (unsigned)glyph_usage.size());
+ 
+		for (std::map<std::pair<std::string, int>, Glyph_Usage>::iterator it = glyph_usage.begin(); it != glyph_usage.end(); ++it)
+		{
+			const std::string& font_path = it->first.first;
+			std::vector<unsigned long> ordered = order_by_co_occurrence(it->second);
+ 
+			write_profile_value(profile, (unsigned)font_path.size());
+			profile.write(font_path.c_str(), font_path.size());
+			write_profile_value(profile, it->first.second);
+			write_profile_value(profile, (unsigned)ordered.size());
+ 
+			for (unsigned i = 0; i < ordered.size(); ++i)
+			{
+				write_profile_value(profile, (unsigned)ordered[i]);
+				write_profile_value(profile, it->second.codepoint_counts[ordered[i]]);
+			}
+		}
+	}
+ 
+	// Call at start-up (before the scene's messages are created)... every profiled alphabet is rasterised & packed in advance, in co-occurrence order,
+	// followed by any remaining "alphabet_string" characters so that glyphs missing from the profile are still available.
+	void warm_up_from_profile(std::string profile_path)
+	{
+		std::ifstream profile(profile_path, std::ios::binary | std::ios::ate);
+		std::streamoff profile_size = profile.is_open() ? (std::streamoff)profile.tellg() : 0;
+		profile.seekg(0);
+ 
+		char magic[4] = {};
+		profile.read(magic, 4);
+ 
+		if (!profile.is_open() || !profile.good() || std::string(magic, 4) != "GUP1")
+		{
+			std::cout << "\n   Warning: warm_up_from_profile(...) --- no valid usage profile at: " << profile_path << "\n";
+			return;
+		}
+		auto bytes_left = [&profile, profile_size]() // Every length read is checked against this before anything is allocated (a truncated or corrupt profile stops the warm-up)
+			{
+				return profile.good() ? profile_size - (std::streamoff)profile.tellg() : 0;
+			};
+		unsigned alphabet_count = read_profile_value<unsigned>(profile);
+		bool profile_valid = profile.good();
+ 
+		std::deque<Message_Parent> new_alphabets; // Deque, so each stays in place while its job rasterises it.
+		std::vector<Job_System::Job_Handle> alphabet_jobs;
+ 
+		for (unsigned a = 0; a < alphabet_count && profile_valid; ++a)
+		{
+			unsigned path_length = read_profile_value<unsigned>(profile);
+			if (!profile.good() || path_length > bytes_left())
+			{
+				profile_valid = false;
+				break;
+			}
+			std::string font_path(path_length, '\0');
+			if (!font_path.empty())
+				profile.read(&font_path[0], font_path.size());
+ 
+			int font_size = read_profile_value<int>(profile);
+			unsigned glyph_count = read_profile_value<unsigned>(profile);
+ 
+			if (!profile.good() || glyph_count > bytes_left() / (2 * sizeof(unsigned))) // (codepoint, count) pairs.
+			{
+				profile_valid = false;
+				break;
+			}
+			std::u32string profiled_characters;
+			profiled_characters.reserve(glyph_count);
+ 
+			for (unsigned i = 0; i < glyph_count; ++i)
+			{
+				unsigned long codepoint = read_profile_value<unsigned>(profile);
+				read_profile_value<unsigned>(profile); // The count only decided the order, when the profile was saved.
+ 
+				if (!profile.good())
+				{
+					profile_valid = false;
+					break;
+				}
+				profiled_characters += (char32_t)codepoint;
+			}
+			if (!profile_valid)
+				break;
+ 
+			for (unsigned i = 0; i < alphabet_codepoints.size(); ++i)
+				if (profiled_characters.find(alphabet_codepoints[i]) == std::u32string::npos)
+					profiled_characters += alphabet_codepoints[i];
+ 
+			if (find_alphabet(messages, font_path, font_size) != -1)
+				continue;
+ 
+			new_alphabets.emplace_back(&message_arena); // An alphabet-only entry (empty message) that later messages copy from.
+			Message_Parent& new_message = new_alphabets.back();
+ 
+			new_message.font_size = font_size;
+			new_message.font_path = font_path;
+			new_message.fallback_font_paths = fallback_font_paths;
+			new_message.alphabet_characters = profiled_characters;
+			new_message.glyph_pixel_scale = 1.0f / dpi_scale;
+ 
+			alphabet_jobs.push_back(submit_alphabet_job(new_message)); // Every profiled alphabet is rasterised in parallel.
+		}
+		if (!profile_valid) // The alphabets read before the damage are still warmed up.
+			std::cout << "\n   Warning: warm_up_from_profile(...) --- no valid usage profile at: " << profile_path << " (truncated or corrupt)\n";
+ 
+		jobs().wait(alphabet_jobs);
+ 
+		for (Message_Parent& new_message : new_alphabets)
+		{
+			upload_alphabet_job(new_message);
+			initialise_buffer_data_message(new_message); // Empty buffer... keeps draw_messages() valid for this entry.
+			messages.push_back(std::move(new_message));
+		}
+	}
+ 
+	// Text bundles: fixed string tables (e.g. 1 localisation) rasterised & laid out offline, by the "Compiler" project's text_compiler... see: save_text_bundle(...)
+	// -------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	struct Bundle_Source // 1 font spec and its string table, as passed to: save_text_bundle(...)
+	{
+		std::string font_path;
+		int font_size = 10;
+		std::vector<std::string> fallback_font_paths; // As set_fallback_fonts(...), for this source's alphabet.
+		std::vector<std::string> strings;
+	};
+ 
+	// Offline (no renderer calls, so no window is needed): rasterises each source's alphabet and lays out each string at pixel (0, 0), exactly as share_glyph_run(...) would.
+	// "TXB2", the DPI scale rasterised at, source count, then per source: font path, fallback paths, font size, atlas & glyph metrics, then string count and per string: text, start position, per-quad arrays & quads.
+	bool save_text_bundle(std::string bundle_path, const std::vector<Bundle_Source>& sources)
+	{
+		std::ofstream bundle(bundle_path, std::ios::binary);
+		if (!bundle.is_open())
+		{
+			std::cout << "\n   Warning: save_text_bundle(...) --- could not open: " << bundle_path << "\n";
+			return false;
+		}
+		bundle.write("TXB2", 4);
+		write_profile_value(bundle, dpi_scale);
+		write_profile_value(bundle, (unsigned)sources.size());
+ 
+		for (const Bundle_Source& source : sources)
+		{
+			Message_Parent alphabet; // As rasterised by the async worker... private faces, nothing uploaded.
+			alphabet.font_size = source.font_size;
+			alphabet.font_path = source.font_path;
+			alphabet.fallback_font_paths = source.fallback_font_paths;
+			alphabet.alphabet_characters = alphabet_codepoints;
+			alphabet.glyph_pixel_scale = 1.0f / dpi_scale;
+ 
+			Face_Chain chain;
+			chain.private_faces = true;
+ 
+			set_font_parameters(alphabet, chain);
+			calculate_alphabet_image_size(alphabet, chain);
+			format_alphabet_texture_image(alphabet, chain);
+			close_face_chain(chain);
+ 
+			const Alphabet_Metrics& metrics = *alphabet.alphabet_metrics;
+			unsigned glyph_count = metrics.size();
+ 
+			write_profile_string(bundle, source.font_path);
+			write_profile_value(bundle, (unsigned)source.fallback_font_paths.size());
+			for (const std::string& fallback_path : source.fallback_font_paths)
+				write_profile_string(bundle, fallback_path);
+ 
+			write_profile_value(bundle, source.font_size);
+			write_profile_value(bundle, alphabet.alphabet_texture_width);
+			write_profile_value(bundle, alphabet.alphabet_texture_height);
+			write_profile_value(bundle, alphabet.tallest_font_height);
+			write_profile_value(bundle, alphabet.relative_distance);
+			write_profile_value(bundle, metrics.ascender);
+			write_profile_value(bundle, metrics.descender);
+			write_profile_value(bundle, metrics.line_height);
+ 
+			write_profile_value(bundle, glyph_count);
+			bundle.write((const char*)metrics.codepoint.data(), glyph_count * sizeof(char32_t));
+			bundle.write((const char*)metrics.glyph_advance_x.data(), glyph_count * sizeof(float));
+			bundle.write((const char*)metrics.left_bearing.data(), glyph_count * sizeof(float));
+			bundle.write((const char*)metrics.bottom_bearing.data(), glyph_count * sizeof(float));
+			bundle.write((const char*)metrics.width_plus_padding.data(), glyph_count * sizeof(float));
+			bundle.write((const char*)metrics.height_plus_padding.data(), glyph_count * sizeof(float));
+			bundle.write((const char*)metrics.texcoord_rect.data(), glyph_count * 4 * sizeof(unsigned short));
+			bundle.write((const char*)alphabet.alphabet_pixels.data(), alphabet.alphabet_pixels.size());
+ 
+			write_profile_value(bundle, (unsigned)source.strings.size());
+ 
+			for (const std::string& string : source.strings)
+			{
+				Message_Parent run;
+				copy_alphabet(run, alphabet);
+				run.message_string.assign(string.data(), string.size());
+				process_text_compare(run, 0, 0);
+ 
+				unsigned quad_count = (unsigned)run.characters_quads.size();
+ 
+				write_profile_string(bundle, string);
+				write_profile_value(bundle, run.text_start_x);
+				write_profile_value(bundle, run.text_start_y);
+				write_profile_value(bundle, quad_count);
+				bundle.write((const char*)run.start_x_current.data(), quad_count * sizeof(float));
+				bundle.write((const char*)run.quad_character.data(), quad_count * sizeof(unsigned));
+				bundle.write((const char*)run.characters_quads.data(), quad_count * sizeof(Message_Characters)); // Ready to upload as they are.
+			}
+		}
+		return bundle.good();
+	}
+ 
+	// Call at start-up (before the scene's messages are created)... the bundle is memory-mapped and each atlas & glyph run is uploaded straight from the mapping, with no FreeType or layout work.
+	// Each alphabet becomes an alphabet-only entry (as in warm_up_from_profile(...)) and each run joins "glyph_run_cache", so create_text_message(...) shares them too. Returns the index of the bundle's 1st string.
+	unsigned load_text_bundle(std::string bundle_path)
+	{
+		unsigned first_string = (unsigned)bundle_strings.size();
+ 
+		Mapped_File mapped(bundle_path);
+		Bundle_Reader reader{ mapped.data, mapped.size };
+ 
+		const char* magic = reader.bytes(4);
+		if (!magic || std::string(magic, 4) != "TXB2")
+		{
+			std::cout << "\n   Warning: load_text_bundle(...) --- no valid text bundle at: " << bundle_path << "\n";
+			return first_string;
+		}
+		float bundle_dpi_scale = reader.value<float>();
+		if (bundle_dpi_scale != dpi_scale)
+		{
+			std::cout << "\n   Warning: load_text_bundle(...) --- " << bundle_path << " was rasterised at DPI scale " << bundle_dpi_scale << " (not " << dpi_scale << ")\n";
+			return first_string;
+		}
+		unsigned source_count = reader.value<unsigned>();
+ 
+		// Parse everything first (the mapping is only read), so that a truncated bundle creates no renderer resources at all.
+		// ---------------------------------------------------------------------------------------------------------------
+		std::vector<Message_Parent> alphabets;
+		std::vector<const char*> alphabet_pixels;
+		std::vector<std::shared_ptr<Glyph_Run>> runs;
+		std::vector<unsigned> run_alphabet;
+		std::vector<const char*> run_quads;
+ 
+		for (unsigned a = 0; a < source_count && reader.valid; ++a)
+		{
+			Message_Parent alphabet(&message_arena);
+			alphabet.font_path = reader.string();
+ 
+			unsigned fallback_count = reader.value<unsigned>();
+			for (unsigned i = 0; i < fallback_count && reader.valid; ++i)
+				alphabet.fallback_font_paths.push_back(reader.string());
+ 
+			alphabet.font_size = reader.value<int>();
+			alphabet.alphabet_texture_width = reader.value<int>();
+			alphabet.alphabet_texture_height = reader.value<int>();
+			alphabet.tallest_font_height = reader.value<int>();
+			alphabet.relative_distance = reader.value<int>();
+			alphabet.glyph_pixel_scale = 1.0f / bundle_dpi_scale;
+			alphabet.draw_alphabet = false;
+ 
+			std::shared_ptr<Alphabet_Metrics> metrics = std::make_shared<Alphabet_Metrics>();
+			metrics->ascender = reader.value<int>();
+			metrics->descender = reader.value<int>();
+			metrics->line_height = reader.value<int>();
+ 
+			unsigned glyph_count = reader.value<unsigned>();
+			reader.copy_array<char32_t>(metrics->codepoint, glyph_count);
+			reader.copy_array<float>(metrics->glyph_advance_x, glyph_count);
+			reader.copy_array<float>(metrics->left_bearing, glyph_count);
+			reader.copy_array<float>(metrics->bottom_bearing, glyph_count);
+			reader.copy_array<float>(metrics->width_plus_padding, glyph_count);
+			reader.copy_array<float>(metrics->height_plus_padding, glyph_count);
+			reader.copy_array<unsigned short>(metrics->texcoord_rect, glyph_count * 4);
+ 
+			size_t pixel_count = (size_t)std::max(alphabet.alphabet_texture_width, 0) * (size_t)std::max(alphabet.alphabet_texture_height, 0);
+			alphabet_pixels.push_back(reader.array<unsigned char>(pixel_count));
+ 
+			if (!reader.valid)
+				break;
+ 
+			for (unsigned i = 0; i < glyph_count; ++i)
+			{
+				char32_t codepoint = metrics->codepoint[i];
+				if (metrics->glyph_index(codepoint) == -1) // The 1st occurrence wins, as in: format_alphabet_texture_image(...)
+				{
+					if (codepoint < 128)
+						metrics->character_lookup[codepoint] = (int)i;
+					else
+						metrics->codepoint_lookup[codepoint] = (int)i;
+				}
+			}
+			alphabet.alphabet_characters.assign(metrics->codepoint.begin(), metrics->codepoint.end());
+			alphabet.alphabet_metrics = metrics;
+ 
+			unsigned string_count = reader.value<unsigned>();
+			for (unsigned i = 0; i < string_count && reader.valid; ++i)
+			{
+				std::shared_ptr<Glyph_Run> run = std::make_shared<Glyph_Run>();
+				run->message_string = reader.string();
+				run->alphabet_metrics = metrics;
+				run->text_start_x = reader.value<float>();
+				run->text_start_y = reader.value<float>();
+				run->quad_count = reader.value<unsigned>();
+				reader.copy_array<float>(run->start_x_current, run->quad_count);
+				reader.copy_array<unsigned>(run->quad_character, run->quad_count);
+ 
+				run_quads.push_back(reader.array<Message_Characters>(run->quad_count));
+				run_alphabet.push_back(a);
+				runs.push_back(run);
+			}
+			alphabets.push_back(std::move(alphabet));
+		}
+		if (!reader.valid)
+		{
+			std::cout << "\n   Warning: load_text_bundle(...) --- truncated text bundle: " << bundle_path << "\n";
+			return first_string;
+		}
+ 
+		// Upload... the atlases and quads go to the renderer straight from the mapping.
+		// ----------------------------------------------------------------------
+		unsigned first_alphabet_message = (unsigned)messages.size();
+ 
+		for (unsigned a = 0; a < alphabets.size(); ++a)
+		{
+			Message_Parent& alphabet = alphabets[a];
+			renderer.create_atlas_texture(alphabet.alphabet_texture);
+			renderer.upload_atlas_pixels(alphabet.alphabet_texture, alphabet.alphabet_texture_width, alphabet.alphabet_texture_height, (const unsigned char*)alphabet_pixels[a]);
+			register_measure_alphabet(alphabet);
+ 
+			initialise_buffer_data_message(alphabet); // Empty buffer... keeps draw_messages() valid for this entry.
+			messages.push_back(std::move(alphabet));
+		}
+		for (unsigned i = 0; i < runs.size(); ++i)
+		{
+			Glyph_Run& run = *runs[i];
+			const Message_Parent& alphabet = messages[first_alphabet_message + run_alphabet[i]];
+ 
+			renderer.create_quad_buffer(run.VAO_run, run.VBO_run, run.quad_count * sizeof(Message_Characters), run_quads[i], Text_Buffer_Usage::static_draw);
+ 
+			glyph_run_cache.emplace(glyph_run_key(run.message_string, alphabet.font_path, alphabet.font_size), runs[i]); // An existing entry is kept.
+			bundle_strings.push_back({ runs[i], first_alphabet_message + run_alphabet[i] });
+		}
+		return first_string;
+	}
+ 
+	// Draws bundle string "bundle_string" (as returned by load_text_bundle(...), plus its position in the bundle) from its pre-built glyph run.
+	unsigned create_bundle_message(unsigned bundle_string, int text_start_x, int text_start_y)
+	{
+		const Bundle_String& entry = bundle_strings[bundle_string];
+		const Message_Parent& alphabet = messages[entry.alphabet_message];
+ 
+		Message_Parent new_message(&message_arena);
+		new_message.font_size = alphabet.font_size;
+		new_message.font_path = alphabet.font_path;
+		new_message.fallback_font_paths = alphabet.fallback_font_paths;
+		copy_alphabet(new_message, alphabet);
+ 
+		attach_glyph_run(new_message, entry.run, text_start_x, text_start_y);
+		return store_message(new_message);
+	}
+ 
+	void create_text_message(std::string message, int text_start_x, int text_start_y, std::string font_path, int font_size, bool dynamic_static)
+	{
+		Message_Parent new_message(&message_arena); // Changed by reference during most of the below function calls.
+ 
+		prepare_message_alphabet(new_message, messages, font_path, font_size);
+ 
+		if (!dynamic_static && !message.empty())
+		{
+			share_glyph_run(new_message, message, text_start_x, text_start_y);
+			store_message(new_message);
+			return;
+		}
+		new_message.message_string.assign(message.data(), message.size());
+		process_text_compare(new_message, text_start_x, text_start_y); // process_text_index(...) is called within this function call.
+ 
+		new_message.dynamic_static = dynamic_static; // True = dynamic.
+		initialise_buffer_data_message(new_message); // Initialise the message's buffer data.
+		update_buffer_data_message(new_message, 0); // Update the message's buffer data.
+ 
+		store_message(new_message); // Add the new message to the list of messages (moved, so no per-glyph data is copied)
+	}
+ 
+	// Paragraph mode: lines wrap at "max_width" pixels (and at '\n')... returns the message's index, for: edit_paragraph_text(...) & set_paragraph_width(...)
+	unsigned create_paragraph_message(std::string message, int text_start_x, int text_start_y, std::string font_path, int font_size, int max_width, Text_Alignment alignment, bool dynamic_static)
+	{
+		Message_Parent new_message(&message_arena);
+ 
+		prepare_message_alphabet(new_message, messages, font_path, font_size);
+ 
+		new_message.message_string.assign(message.data(), message.size());
+		new_message.paragraph = true;
+		new_message.paragraph_max_width = (float)max_width;
+		new_message.paragraph_alignment = alignment;
+		new_message.requested_start_x = text_start_x;
+		new_message.requested_start_y = text_start_y;
+		new_message.dynamic_static = dynamic_static;
+ 
+		reflow_paragraph(new_message, UINT_MAX, UINT_MAX, 0);
+ 
+		initialise_buffer_data_message(new_message);
+		upload_quad_range(new_message, 0, (unsigned)new_message.characters_quads.size());
+ 
+		return store_message(new_message);
+	}
+ 
+	// Replaces "erase_count" characters from "first_character" with "insert_text"... only the lines around the edit are re-broken & laid out, and only changed vertex ranges are uploaded.
+	void edit_paragraph_text(unsigned message_index, unsigned first_character, unsigned erase_count, std::string insert_text)
+	{
+		Message_Parent& message = messages[message_index];
+ 
+		if (first_character > message.message_string.size())
+			first_character = (unsigned)message.message_string.size();
+		if (erase_count > message.message_string.size() - first_character)
+			erase_count = (unsigned)message.message_string.size() - first_character;
+ 
+		message.message_string.replace(first_character, erase_count, insert_text.data(), insert_text.size());
+ 
+		unsigned first_dirty_quad = reflow_paragraph(message, first_character, first_character + erase_count, (int)insert_text.size() - (int)erase_count);
+		upload_quad_range(message, first_dirty_quad, (unsigned)message.characters_quads.size());
+ 
+		if (!message.spans.empty())
+		{
+			for (Text_Span& span : message.spans) // Spans move with the text after the edit (characters inserted within a span join it)
+			{
+				span.first_character = shift_span_edge(span.first_character, first_character, erase_count, (unsigned)insert_text.size());
+				span.end_character = shift_span_edge(span.end_character, first_character, erase_count, (unsigned)insert_text.size());
+			}
+			upload_span_attributes(message);
+		}
+	}
+ 
+	// Lines whose break is still valid at the new width are kept (at most shifted for alignment), the rest are re-broken.
+	void set_paragraph_width(unsigned message_index, int max_width)
+	{
+		Message_Parent& message = messages[message_index];
+		message.paragraph_max_width = (float)max_width;
+ 
+		unsigned first_dirty_quad = reflow_paragraph(message, UINT_MAX, UINT_MAX, 0);
+		upload_quad_range(message, first_dirty_quad, (unsigned)message.characters_quads.size());
+ 
+		if (!message.spans.empty())
+			upload_span_attributes(message); // Re-broken lines can change the quad count.
+	}
+ 
+	// Rich text: colours, styles & shadow flags per character range, stored as a per-vertex attribute... so a multi-colour message is still 1 draw call with no uniform changes.
+	// Later spans take precedence where they overlap, and characters outside every span keep the "font_colour" uniform. An empty "spans" removes them.
+	void set_message_spans(unsigned message_index, const std::vector<Text_Span>& spans)
+	{
+		Message_Parent& message = messages[message_index];
+ 
+		if (message.glyph_run || message.batch_buffer)
+		{
+			std::cout << "\n   Warning: set_message_spans(...) --- message " << message_index << " shares its vertex array (static glyph run or batch)... create it as dynamic to give it spans.";
+			return;
+		}
+		message.spans = spans;
+ 
+		if (!message.glyphs_pending) // Otherwise applied once the real glyphs arrive, in: finish_async_message(...)
+			upload_span_attributes(message);
+	}
+ 
+	// Virtualized document (e.g. a multi-megabyte log): the text is split into chunks of lines, and only the chunks within the view rectangle are ever laid out & uploaded...
+	// ...chunk buffers that scroll out of view are recycled, so memory & per-frame cost depend on the view size rather than the document size. Returns the document's index.
+	unsigned create_document(std::string text, int view_x, int view_y, int view_width, int view_height, std::string font_path, int font_size)
+	{
+		documents.emplace_back();
+		Document& document = documents.back();
+ 
+		document.text = std::move(text);
+		document.view_x = view_x;
+		document.view_y = view_y;
+		document.view_width = view_width;
+		document.view_height = view_height;
+ 
+		document.line_starts.push_back(0);
+		for (const char* newline = (const char*)memchr(document.text.data(), '\n', document.text.size()); newline; newline = (const char*)memchr(newline + 1, '\n', document.text.data() + document.text.size() - (newline + 1)))
+			document.line_starts.push_back((unsigned)(newline + 1 - document.text.data()));
+ 
+		prepare_layout_alphabet(document.layout, font_path, font_size);
+		document.layout.draw_alphabet = false;
+		document.layout.requested_start_x = view_x;
+		document.layout.requested_start_y = view_y;
+ 
+		float min_advance = FLT_MAX;
+		for (unsigned i = 0; i < document.layout.alphabet_metrics->size(); ++i)
+			if (document.layout.alphabet_metrics->glyph_advance_x[i] > 0.0f)
+				min_advance = std::min(min_advance, document.layout.alphabet_metrics->glyph_advance_x[i]);
+ 
+		document.max_line_glyphs = (min_advance == FLT_MAX) ? 0 : (unsigned)(view_width / min_advance) + 1;
+ 
+		return (unsigned)documents.size() - 1;
+	}
+ 
+	// Clamped to the document's height... scrolling within the chunks already laid out is only a uniform change.
+	void scroll_document(unsigned document_index, float scroll_y)
+	{
+		Document& document = documents[document_index];
+ 
+		float line_height = (document.layout.tallest_font_height + alphabet_padding) * document.layout.glyph_pixel_scale;
+		float max_scroll = std::max(0.0f, document.line_starts.size() * line_height - document.view_height);
+ 
+		document.scroll_y = std::max(0.0f, std::min(scroll_y, max_scroll));
+	}
+ 
+	void draw_documents()
+	{
+		if (documents.empty())
+			return;
+ 
+		renderer.begin_quads();
+ 
+		for (Document& document : documents)
+		{
+			update_document_chunks(document);
+ 
+			int clip_top = (int)std::lround(document.view_y * dpi_scale); // Framebuffer pixels.
+			int clip_bottom = (int)std::lround((document.view_y + document.view_height) * dpi_scale);
+			renderer.begin_clip((int)std::lround(document.view_x * dpi_scale), clip_top, (int)std::lround(document.view_width * dpi_scale), clip_bottom - clip_top);
+ 
+			for (const Document_Chunk& chunk : document.chunks)
+				if (chunk.chunk_index != -1 && chunk.quad_count > 0)
+					renderer.draw_quads(chunk.VAO_chunk, document.layout.alphabet_texture, 0, chunk.quad_count, glm::vec2(0.0f, document.scroll_y)); // Chunks are laid out unscrolled.
+ 
+			renderer.end_clip();
+		}
+		renderer.end_quads();
+	}
+ 
+	// Log mode: lines are appended (1 sub-range upload each) into a fixed ring of "capacity_quads" glyph quads, expiring the oldest lines as the ring or "max_lines" fills...
+	// ...nothing is re-laid out or reallocated while the log runs, and scrolling is only a uniform offset. Shows "visible_rows" lines down from (log_x, log_y)... returns the log's index.
+	unsigned create_log(int log_x, int log_y, unsigned visible_rows, unsigned max_lines, unsigned capacity_quads, std::string font_path, int font_size)
+	{
+		logs.emplace_back();
+		Text_Log& log = logs.back();
+ 
+		log.log_x = log_x;
+		log.log_y = log_y;
+		log.visible_rows = visible_rows;
+		log.capacity_quads = capacity_quads > 0 ? capacity_quads : 1;
+		log.lines.resize(max_lines > 0 ? max_lines : 1);
+ 
+		prepare_layout_alphabet(log.layout, font_path, font_size);
+		log.layout.draw_alphabet = false;
+ 
+		log.layout.characters_quads.reserve(log.capacity_quads); // Scratch space, sized once for the longest possible line.
+		log.layout.start_x_current.reserve(log.capacity_quads);
+		log.layout.quad_character.reserve(log.capacity_quads);
+ 
+		renderer.create_quad_buffer(log.VAO_log, log.VBO_log, log.capacity_quads * sizeof(Message_Characters), nullptr, Text_Buffer_Usage::dynamic_draw);
+ 
+		return (unsigned)logs.size() - 1;
+	}
+ 
+	void append_log_line(unsigned log_index, const std::string& line)
+	{
+		Text_Log& log = logs[log_index];
+		Message_Parent& layout = log.layout;
+ 
+		static thread_local std::vector<unsigned> glyph_indices;
+		glyph_indices.clear();
+		layout.characters_quads.clear();
+		layout.start_x_current.clear();
+		layout.quad_character.clear();
+ 
+		collect_glyphs(*layout.alphabet_metrics, line.data(), 0, line.size(), glyph_indices, layout.quad_character);
+		unsigned quad_count = std::min((unsigned)glyph_indices.size(), log.capacity_quads); // A line longer than the whole ring is cut.
+ 
+		unsigned long long serial = log.next_serial++;
+		float line_height = (layout.tallest_font_height + alphabet_padding) * layout.glyph_pixel_scale;
+ 
+		if (quad_count > 0)
+		{
+			layout.characters_quads.resize(quad_count);
+			layout.start_x_current.resize(quad_count);
+ 
+			layout.text_start_x = log.log_x - alphabet_padding * layout.glyph_pixel_scale; // As with a paragraph's lines.
+			layout.text_start_y = -log.log_y + (layout.relative_distance - layout.tallest_font_height - alphabet_padding) * layout.glyph_pixel_scale - (serial % log_wrap_lines) * line_height;
+			process_text_quads(layout, &glyph_indices[0], quad_count, 0);
+		}
+		if (log.write_quad + quad_count > log.capacity_quads)
+			log.write_quad = 0; // Wrap... the few quads left at the end go unused this lap.
+ 
+		// Expire the oldest lines overlapping the new line's quads (or the oldest when "max_lines" is reached)... advancing the tail is all it takes.
+		// The held lines' quads run on around the ring from the oldest, so only the oldest line holding quads can overlap (empty lines hold none)...
+		// while it does, it expires along with any empty lines before it.
+		// -------------------------------------------------------------------------------------------------------------------------------------------------------
+		unsigned empty_lines = 0; // Empty lines at the tail, before the oldest line holding quads.
+		while (log.line_count > empty_lines)
+		{
+			const Log_Line& oldest = log.lines[(log.oldest_line + empty_lines) % log.lines.size()];
+			if (oldest.quad_count == 0)
+			{
+				++empty_lines;
+				continue;
+			}
+			bool overlaps = quad_count > 0 && oldest.first_quad < log.write_quad + quad_count && log.write_quad < oldest.first_quad + oldest.quad_count;
+			if (!overlaps)
+				break;
+ 
+			log.oldest_line = (log.oldest_line + empty_lines + 1) % log.lines.size();
+			log.line_count -= empty_lines + 1;
+			empty_lines = 0;
+		}
+		if (log.line_count == log.lines.size())
+		{
+			log.oldest_line = (log.oldest_line + 1) % log.lines.size();
+			--log.line_count;
+		}
+		Log_Line& new_line = log.lines[(log.oldest_line + log.line_count) % log.lines.size()];
+		new_line.serial = serial;
+		new_line.first_quad = log.write_quad;
+		new_line.quad_count = quad_count;
+		++log.line_count;
+ 
+		if (quad_count > 0)
+			renderer.update_quad_buffer(log.VBO_log, log.write_quad * sizeof(Message_Characters), quad_count * sizeof(Message_Characters), layout.characters_quads.data());
+ 
+		log.write_quad += quad_count;
+		scroll_log(log_index, log.scroll_rows); // Clamped again, as expiry may have left fewer lines to scroll back through.
+	}
+ 
+	// 0 = showing the newest lines... clamped to the oldest line still held.
+	void scroll_log(unsigned log_index, unsigned rows_back)
+	{
+		Text_Log& log = logs[log_index];
+		log.scroll_rows = (log.line_count > log.visible_rows) ? std::min(rows_back, log.line_count - log.visible_rows) : 0;
+	}
+ 
+	void draw_logs()
+	{
+		if (logs.empty())
+			return;
+ 
+		renderer.begin_quads();
+ 
+		for (const Text_Log& log : logs)
+		{
+			if (log.line_count == 0)
+				continue;
+ 
+			unsigned shown = std::min(log.visible_rows, log.line_count);
+			unsigned first_shown = log.line_count - shown - log.scroll_rows; // Counted from the oldest line held.
+ 
+			unsigned long long first_serial = log.lines[(log.oldest_line + first_shown) % log.lines.size()].serial;
+			float line_height = (log.layout.tallest_font_height + alphabet_padding) * log.layout.glyph_pixel_scale;
+ 
+			// Consecutive lines are drawn together while their quads stay contiguous in the ring and their rows share 1 wrap of "log_wrap_lines"...
+			// ...so a screenful is 1 draw, or a few where the ring or the row numbering wraps. Each draw's offset moves its rows up to the view's top.
+			// -----------------------------------------------------------------------------------------------------------------------------------------------
+			unsigned run_first_quad = 0, run_quads = 0;
+			unsigned long long run_wrap = 0;
+ 
+			for (unsigned i = 0; i <= shown; ++i)
+			{
+				const Log_Line* line = (i < shown) ? &log.lines[(log.oldest_line + first_shown + i) % log.lines.size()] : nullptr;
+				unsigned long long wrap = line ? line->serial / log_wrap_lines : 0;
+ 
+				bool continues = line && run_quads > 0 && wrap == run_wrap && line->first_quad == run_first_quad + run_quads;
+				if (!continues && run_quads > 0)
+				{
+					float offset_y = (float)((long long)first_serial - (long long)(run_wrap * log_wrap_lines)) * line_height;
+					renderer.draw_quads(log.VAO_log, log.layout.alphabet_texture, run_first_quad, run_quads, glm::vec2(0.0f, offset_y));
+					run_quads = 0;
+				}
+				if (line && line->quad_count > 0)
+				{
+					if (run_quads == 0)
+					{
+						run_first_quad = line->first_quad;
+						run_wrap = wrap;
+					}
+					run_quads += line->quad_count;
+				}
+			}
+		}
+		renderer.end_quads();
+	}
+ 
+	// Terminal-grid mode (e.g. an in-game console): "columns" x "rows" monospace cells, sized from the font's 'M' advance & line height... returns the grid's index.
+	// Changing a cell is a 4-byte texel write (no vertex data is rebuilt)... drawn via: draw_terminal_grids(...)
+	unsigned create_terminal_grid(int grid_x, int grid_y, unsigned columns, unsigned rows, std::string font_path, int font_size)
+	{
+		terminal_grids.emplace_back();
+		Terminal_Grid& grid = terminal_grids.back();
+ 
+		prepare_layout_alphabet(grid.layout, font_path, font_size);
+		grid.layout.draw_alphabet = false;
+ 
+		const Alphabet_Metrics& metrics = *grid.layout.alphabet_metrics;
+ 
+		grid.grid_x = grid_x;
+		grid.grid_y = grid_y;
+		grid.columns = columns > 0 ? columns : 1;
+		grid.rows = rows > 0 ? rows : 1;
+ 
+		int widest_glyph = metrics.glyph_index('M');
+		if (widest_glyph == -1)
+			widest_glyph = (int)(std::max_element(metrics.glyph_advance_x.begin(), metrics.glyph_advance_x.end()) - metrics.glyph_advance_x.begin());
+ 
+		grid.cell_width = (int)std::lround(metrics.glyph_advance_x[widest_glyph] / grid.layout.glyph_pixel_scale); // Rasterised pixels, as the atlas is sampled in.
+		grid.cell_height = (metrics.line_height > 0) ? metrics.line_height : grid.layout.tallest_font_height + alphabet_padding;
+		int baseline = (metrics.ascender > 0) ? metrics.ascender : grid.layout.tallest_font_height; // Pixels down from a cell's top.
+ 
+		// Glyph table: the atlas rectangle (including the padding) & where it sits within a cell, so the glyph's bitmap lands at: pen + bitmap_left, on the baseline.
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------
+		std::vector<short> glyph_table(metrics.size() * 4 * 2);
+		int texture_width = grid.layout.alphabet_texture_width;
+		int texture_height = grid.layout.alphabet_texture_height;
+ 
+		for (unsigned i = 0; i < metrics.size(); ++i)
+		{
+			int left = (int)std::lround(metrics.texcoord(i, 0) * texture_width);
+			int top = (int)std::lround(metrics.texcoord(i, 1) * texture_height); // The atlas rows run top-down, so the "bottom" texture coordinate is the glyph's top row.
+			int width = (int)std::lround(metrics.texcoord(i, 2) * texture_width) - left;
+			int height = (int)std::lround(metrics.texcoord(i, 3) * texture_height) - top;
+ 
+			int left_bearing = (int)std::lround(metrics.left_bearing[i] / grid.layout.glyph_pixel_scale);
+			int bottom_bearing = (int)std::lround(metrics.bottom_bearing[i] / grid.layout.glyph_pixel_scale);
+ 
+			short* atlas_rect = &glyph_table[i * 4];
+			short* cell_offset = &glyph_table[(metrics.size() + i) * 4];
+ 
+			atlas_rect[0] = (short)left;
+			atlas_rect[1] = (short)top;
+			atlas_rect[2] = (short)width;
+			atlas_rect[3] = (short)height;
+ 
+			cell_offset[0] = (short)(left_bearing - alphabet_padding);
+			cell_offset[1] = (short)(baseline + bottom_bearing + alphabet_padding - height);
+		}
+		grid.cells.assign(grid.columns * grid.rows, 0);
+ 
+		renderer.create_cell_texture(grid.cell_texture, grid.columns, grid.rows, grid.cells.data());
+		renderer.create_glyph_table_texture(grid.glyph_table_texture, metrics.size(), glyph_table.data());
+ 
+		// 1 quad over the whole grid... z, w = pixels from the grid's top-left, from which the fragment shader finds the cell.
+		// ------------------------------------------------------------------------------------------------------------------------------
+		float left = (float)grid_x;
+		float top = (float)-grid_y;
+		float grid_width = (float)(grid.columns * grid.cell_width);
+		float grid_height = (float)(grid.rows * grid.cell_height);
+		float right = left + grid_width * grid.layout.glyph_pixel_scale;
+		float bottom = top - grid_height * grid.layout.glyph_pixel_scale;
+ 
+		Message_Characters quad{};
+		quad.bottom_left_tr1 = glm::vec4(left, bottom, 0.0f, grid_height);
+		quad.bottom_right_tr1 = glm::vec4(right, bottom, grid_width, grid_height);
+		quad.top_left_tr1 = glm::vec4(left, top, 0.0f, 0.0f);
+ 
+		quad.top_left_tr2 = glm::vec4(left, top, 0.0f, 0.0f);
+		quad.top_right_tr2 = glm::vec4(right, top, grid_width, 0.0f);
+		quad.bottom_right_tr2 = glm::vec4(right, bottom, grid_width, grid_height);
+ 
+		renderer.create_quad_buffer(grid.VAO_grid, grid.VBO_grid, sizeof(quad), &quad, Text_Buffer_Usage::static_draw);
+ 
+		return (unsigned)terminal_grids.size() - 1;
+	}
+ 
+	// 1 texel write... codepoints missing from the alphabet (and U+0000) leave the cell empty.
+	void set_grid_cell(unsigned grid_index, unsigned column, unsigned row, char32_t codepoint, glm::vec3 colour = glm::vec3(255.0f))
+	{
+		Terminal_Grid& grid = terminal_grids[grid_index];
+		if (column >= grid.columns || row >= grid.rows)
+			return;
+ 
+		unsigned& cell = grid.cells[row * grid.columns + column];
+		cell = pack_grid_cell(grid, codepoint, colour);
+ 
+		renderer.update_cell_texture(grid.cell_texture, column, row, 1, &cell);
+	}
+ 
+	// UTF-8 "text" written into consecutive cells of 1 row (cut at the row's end), uploaded as 1 texel run.
+	void write_grid_text(unsigned grid_index, unsigned column, unsigned row, const std::string& text, glm::vec3 colour = glm::vec3(255.0f))
+	{
+		Terminal_Grid& grid = terminal_grids[grid_index];
+		if (column >= grid.columns || row >= grid.rows)
+			return;
+ 
+		unsigned end_column = column;
+		for (size_t i = 0; i < text.size() && end_column < grid.columns; ++end_column)
+			grid.cells[row * grid.columns + end_column] = pack_grid_cell(grid, decode_utf8(text.data(), text.size(), i), colour);
+ 
+		if (end_column == column)
+			return;
+ 
+		renderer.update_cell_texture(grid.cell_texture, column, row, end_column - column, &grid.cells[row * grid.columns + column]);
+	}
+ 
+	// Terminal grids use their own shader program (terminal_grid.vert & .frag)... it's made current for the grids, then the previous program is restored.
+	void draw_terminal_grids(unsigned grid_program)
+	{
+		if (terminal_grids.empty())
+			return;
+ 
+		renderer.begin_grids(grid_program);
+ 
+		for (const Terminal_Grid& grid : terminal_grids)
+			renderer.draw_grid(grid.VAO_grid, grid.layout.alphabet_texture, grid.cell_texture, grid.glyph_table_texture, grid.cell_width, grid.cell_height);
+ 
+		renderer.end_grids();
+	}
+ 
+	// Numeric-field mode (scores, timers, FPS): a fixed "capacity" of glyph slots, allocated once... returns the message's index, for: set_numeric_value(...) & set_numeric_text(...)
+	unsigned create_numeric_message(int text_start_x, int text_start_y, std::string font_path, int font_size, unsigned capacity)
+	{
+		Message_Parent new_message(&message_arena);
+ 
+		prepare_message_alphabet(new_message, messages, font_path, font_size);
+ 
+		new_message.dynamic_static = true;
+		new_message.numeric_capacity = capacity > 0 ? capacity : 1;
+		new_message.requested_start_x = text_start_x;
+		new_message.requested_start_y = text_start_y;
+ 
+		position_numeric_message(new_message);
+ 
+		new_message.message_string.assign(new_message.numeric_capacity, '\0');
+		new_message.characters_quads.resize(new_message.numeric_capacity); // Blank slots are zero-area quads.
+		new_message.start_x_current.resize(new_message.numeric_capacity);
+		new_message.quad_character.resize(new_message.numeric_capacity);
+ 
+		initialise_buffer_data_message(new_message);
+		update_buffer_data_message(new_message, 0);
+ 
+		return store_message(new_message);
+	}
+ 
+	// Formats "value" with std::to_chars... "decimal_places" > 0 treats it as fixed-point, e.g. (12345, 2) = "123.45"
+	void set_numeric_value(unsigned message_index, long long value, unsigned decimal_places = 0)
+	{
+		char digits[24]; // Any 64-bit magnitude fits in 20 digits.
+		unsigned long long magnitude = value < 0 ? 0ull - (unsigned long long)value : (unsigned long long)value;
+		unsigned digit_count = (unsigned)(std::to_chars(digits, digits + sizeof(digits), magnitude).ptr - digits);
+ 
+		if (decimal_places > 20)
+			decimal_places = 20;
+ 
+		char text[48];
+		unsigned length = 0;
+ 
+		if (value < 0)
+			text[length++] = '-';
+ 
+		unsigned integer_digits = digit_count > decimal_places ? digit_count - decimal_places : 0;
+		if (integer_digits == 0)
+			text[length++] = '0';
+ 
+		std::memcpy(text + length, digits, integer_digits);
+		length += integer_digits;
+ 
+		if (decimal_places > 0)
+		{
+			text[length++] = '.';
+ 
+			for (unsigned i = digit_count - integer_digits; i < decimal_places; ++i) // Leading zeros of the fraction, e.g. (5, 2) = "0.05"
+				text[length++] = '0';
+ 
+			std::memcpy(text + length, digits + integer_digits, digit_count - integer_digits);
+			length += digit_count - integer_digits;
+		}
+		set_numeric_text(message_index, text, length);
+	}
+ 
+	// Rewrites only the slots whose character or pen position changed, then uploads just that range (e.g. 1 quad = 96 bytes when a timer's last digit ticks over)
+	void set_numeric_text(unsigned message_index, const char* text, size_t length)
+	{
+		Message_Parent& message = messages[message_index];
+ 
+		if (message.numeric_capacity == 0)
+		{
+			std::cout << "\n   Warning: set_numeric_text(...) --- message " << message_index << " was not created via: create_numeric_message(...)";
+			return;
+		}
+		const Alphabet_Metrics& metrics = *message.alphabet_metrics;
+ 
+		unsigned slot = 0;
+		unsigned first_dirty = UINT_MAX, end_dirty = 0;
+		float advanced_current = 0.0f;
+ 
+		size_t i = 0;
+		for (; i < length && slot < message.numeric_capacity; ++i)
+		{
+			int glyph = metrics.glyph_index((unsigned char)text[i]); // Characters missing from the alphabet are skipped (numeric text is ASCII)
+			if (glyph == -1)
+				continue;
+ 
+			// A quad depends only on its glyph & pen position, so an unchanged pair means an unchanged quad.
+			if (message.message_string[slot] != text[i] || message.start_x_current[slot] != message.text_start_x + advanced_current)
+			{
+				process_text_index(message, (unsigned)glyph, advanced_current, slot);
+				message.message_string[slot] = text[i];
+				message.quad_character[slot] = slot; // The slots are the characters shown ('\0' ends them)
+ 
+				first_dirty = std::min(first_dirty, slot);
+				end_dirty = slot + 1;
+			}
+			advanced_current += metrics.glyph_advance_x[glyph];
+			++slot;
+		}
+		if (i < length)
+			std::cout << "\n   Warning: set_numeric_text(...) --- \"" << std::string(text, length) << "\" is longer than the message's " << message.numeric_capacity << " slots, so it has been cut short.";
+ 
+		for (; slot < message.numeric_capacity; ++slot) // Blank the slots left over from a longer previous value.
+		{
+			if (message.message_string[slot] != '\0')
+			{
+				message.characters_quads[slot] = Message_Characters{};
+				message.message_string[slot] = '\0';
+ 
+				first_dirty = std::min(first_dirty, slot);
+				end_dirty = slot + 1;
+			}
+		}
+		if (first_dirty != UINT_MAX)
+			upload_quad_range(message, first_dirty, end_dirty);
+	}
+ 
+	struct Message_Desc // The parameters of 1 message, as passed to: create_text_message(...)
+	{
+		std::string message;
+		int text_start_x = 0;
+		int text_start_y = 0;
+		std::string font_path;
+		int font_size = 10;
+		bool dynamic_static = false;
+	};
+ 
+	// For creating many messages at once (e.g. a scene's labels)... the CPU-only layout runs across all cores, then the render thread does the buffer uploads.
+	void create_text_messages_parallel(const std::vector<Message_Desc>& message_descs)
+	{
+		std::vector<Message_Parent> new_messages;
+		lay_out_message_batch(message_descs.data(), message_descs.size(), new_messages);
+ 
+		// (3) Render thread: buffer uploads.
+		// -----------------------------------
+		for (unsigned i = 0; i < new_messages.size(); ++i)
+		{
+			initialise_buffer_data_message(new_messages[i]);
+			update_buffer_data_message(new_messages[i], 0);
+			store_message(new_messages[i]);
+		}
+	}
+ 
+	// As above, but every static message shares 1 quad buffer, allocated & filled with 1 upload (dynamic messages still get their own, as they're edited in place)
+	// Returns each message's index in "messages" (in "message_descs" order)
+	std::vector<unsigned> create_text_messages(const Message_Desc* message_descs, size_t count)
+	{
+		std::vector<Message_Parent> new_messages;
+		lay_out_message_batch(message_descs, count, new_messages);
+ 
+		size_t batch_quads = 0;
+		for (unsigned i = 0; i < new_messages.size(); ++i)
+		{
+			if (!new_messages[i].dynamic_static)
+			{
+				new_messages[i].buffer_first_quad = (unsigned)batch_quads;
+				batch_quads += new_messages[i].characters_quads.size();
+			}
+		}
+		std::shared_ptr<Batch_Buffer> batch = std::make_shared<Batch_Buffer>();
+		unsigned& VAO_batch = batch->VAO_batch;
+		unsigned& VBO_batch = batch->VBO_batch;
+		if (batch_quads > 0)
+		{
+			renderer.create_quad_buffer(VAO_batch, VBO_batch, batch_quads * sizeof(Message_Characters), nullptr, Text_Buffer_Usage::static_draw);
+			Message_Characters* mapped = (Message_Characters*)renderer.map_quad_buffer(VBO_batch, batch_quads * sizeof(Message_Characters));
+ 
+			if (!mapped)
+				std::cout << "\n   Warning: create_text_messages(...) --- map_quad_buffer(...) failed, so the batch's messages will draw nothing.";
+			else
+			{
+				for (unsigned i = 0; i < new_messages.size(); ++i)
+				{
+					if (!new_messages[i].dynamic_static && !new_messages[i].characters_quads.empty())
+						std::memcpy(mapped + new_messages[i].buffer_first_quad, new_messages[i].characters_quads.data(), new_messages[i].characters_quads.size() * sizeof(Message_Characters));
+				}
+				renderer.unmap_quad_buffer(VBO_batch);
+			}
+		}
+ 
+		std::vector<unsigned> message_indices;
+		message_indices.reserve(new_messages.size());
+ 
+		for (unsigned i = 0; i < new_messages.size(); ++i)
+		{
+			if (new_messages[i].dynamic_static)
+			{
+				initialise_buffer_data_message(new_messages[i]);
+				update_buffer_data_message(new_messages[i], 0);
+			}
+			else
+			{
+				new_messages[i].VAO_message = VAO_batch;
+				new_messages[i].VBO_message = VBO_batch;
+				new_messages[i].batch_buffer = batch;
+				new_messages[i].allocated_memory_bytes = 0; // The buffer belongs to the batch.
+			}
+			message_indices.push_back(store_message(new_messages[i]));
+		}
+		return message_indices;
+	}
+ 
+	std::vector<unsigned> create_text_messages(const std::vector<Message_Desc>& message_descs)
+	{
+		return create_text_messages(message_descs.data(), message_descs.size());
+	}
+ 
+	// Replaces a message's whole text and lays it out again (numeric fields & paragraphs keep their mode)... async messages still waiting on their glyphs are laid out once they arrive.
+	void set_message_text(unsigned message_index, const std::string& text)
+	{
+		Message_Parent& message = messages[message_index];
+ 
+		if (message.removed)
+		{
+			std::cout << "\n   Warning: set_message_text(...) --- message " << message_index << " has been removed.";
+			return;
+		}
+		if (message.numeric_capacity > 0)
+			set_numeric_text(message_index, text.data(), text.size());
+		else if (message.paragraph)
+			edit_paragraph_text(message_index, 0, (unsigned)message.message_string.size(), text);
+		else
+		{
+			message.message_string.assign(text.data(), text.size());
+			if (!message.glyphs_pending)
+				relayout_message(message_index);
+		}
+	}
+ 
+	// Frees the message's buffers and stops drawing it... no other message's index shifts, and its alphabet stays available to new messages.
+	// Its index may then be given to a later message (so create/remove churn doesn't grow "messages"), unless it's the last entry holding its alphabet, or that alphabet is still loading.
+	void remove_message(unsigned message_index)
+	{
+		Message_Parent& message = messages[message_index];
+ 
+		if (message.removed)
+			return;
+ 
+		if (!message.glyph_run && !message.batch_buffer) // Shared buffers belong to the run cache or the batch.
+			renderer.delete_quad_buffer(message.VAO_message, message.VBO_message);
+ 
+		if (message.batch_buffer)
+			release_batch_buffer(message);
+ 
+		if (message.VBO_alphabet)
+			renderer.delete_quad_buffer(message.VAO_alphabet, message.VBO_alphabet);
+ 
+		if (message.VBO_attributes)
+			renderer.delete_vertex_attributes(message.VBO_attributes);
+ 
+		if (message.glyph_run.use_count() == 1) // Neither cached nor shared (its cache key collided), so its buffer is freed with it.
+		{
+			unsigned VAO_run = message.glyph_run->VAO_run, VBO_run = message.glyph_run->VBO_run;
+			renderer.delete_quad_buffer(VAO_run, VBO_run);
+		}
+		message.glyph_run.reset();
+		message.message_string.clear();
+		message.characters_quads.clear();
+		message.start_x_current.clear();
+		message.quad_character.clear();
+		message.lines.clear();
+		message.spans.clear();
+		message.numeric_capacity = 0;
+		message.paragraph = false;
+		message.draw_alphabet = false;
+		message.removed = true;
+ 
+		if (message.glyphs_pending)
+			return;
+ 
+		for (unsigned i = 0; i < messages.size(); ++i)
+		{
+			if (i != message_index && !messages[i].slot_free && messages[i].alphabet_metrics == message.alphabet_metrics) // Another entry that stays (in use, or kept for its alphabet) keeps the alphabet findable.
+			{
+				message.slot_free = true;
+				free_message_slots.push_back(message_index);
+				return;
+			}
+		}
+	}
+ 
+	// Drops the message's share of its batch's quad buffer... the batch's last message deletes it.
+	void release_batch_buffer(Message_Parent& message)
+	{
+		if (message.batch_buffer.use_count() == 1 && message.batch_buffer->VBO_batch)
+			renderer.delete_quad_buffer(message.batch_buffer->VAO_batch, message.batch_buffer->VBO_batch);
+ 
+		message.batch_buffer.reset();
+	}
+ 
+	// Moves "new_message" into a removed message's slot if one is free, otherwise onto the end of "messages"... returns its index.
+	unsigned store_message(Message_Parent& new_message)
+	{
+		if (free_message_slots.empty())
+		{
+			messages.push_back(std::move(new_message));
+			return (unsigned)messages.size() - 1;
+		}
+		unsigned message_index = free_message_slots.back();
+		free_message_slots.pop_back();
+ 
+		messages[message_index] = std::move(new_message);
+		return message_index;
+	}
+ 
+	// Thread-safe submission: any thread may queue message commands (lock-free), which the render thread applies once per frame via: apply_text_commands()
+	// The returned handle can be used straight away in later commands... it maps to an index into "messages" once applied, see: command_message_index(...)
+	unsigned submit_create_message(std::string message, int text_start_x, int text_start_y, std::string font_path, int font_size, bool dynamic_static)
+	{
+		Text_Command command;
+		command.type = Text_Command_Type::create;
+		command.handle = next_message_handle.fetch_add(1, std::memory_order_relaxed);
+		command.text = std::move(message);
+		command.text_start_x = text_start_x;
+		command.text_start_y = text_start_y;
+		command.font_path = std::move(font_path);
+		command.font_size = font_size;
+		command.dynamic_static = dynamic_static;
+ 
+		unsigned handle = command.handle;
+		text_commands.push(std::move(command));
+		return handle;
+	}
+ 
+	void submit_set_message_text(unsigned handle, std::string message)
+	{
+		Text_Command command;
+		command.type = Text_Command_Type::set_text;
+		command.handle = handle;
+		command.text = std::move(message);
+		text_commands.push(std::move(command));
+	}
+ 
+	void submit_remove_message(unsigned handle)
+	{
+		Text_Command command;
+		command.type = Text_Command_Type::remove;
+		command.handle = handle;
+		text_commands.push(std::move(command));
+	}
+ 
+	// Render thread only... UINT_MAX if the handle's message hasn't been created yet (or has been removed)
+	unsigned command_message_index(unsigned handle) const
+	{
+		return handle < handle_messages.size() ? handle_messages[handle] : UINT_MAX;
+	}
+ 
+	// Render thread, once per frame before the draws: applies every command submitted since the last call. The frame's new messages are laid out across all cores
+	// and uploaded as 1 batch (as in: create_text_messages(...)), and a message edited several times in 1 frame is only laid out for its last text. Called before
+	// the frame's draws are issued, this CPU work overlaps the GPU still working through the previous frame... edits upload into new buffers, so they never wait on it.
+	void apply_text_commands()
+	{
+		applied_commands.clear();
+		last_handle_command.clear();
+ 
+		Text_Command command;
+		while (text_commands.pop(command))
+		{
+			last_handle_command[command.handle] = applied_commands.size();
+			applied_commands.push_back(std::move(command));
+		}
+		if (applied_commands.empty())
+			return;
+ 
+		// (1) Creates: 1 parallel layout & batch upload (a handle's create is always drained before its later commands, as it was pushed before the handle was returned)
+		// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		std::vector<Message_Desc> message_descs;
+		std::vector<unsigned> created_handles;
+ 
+		for (const Text_Command& applied : applied_commands)
+		{
+			if (applied.type != Text_Command_Type::create)
+				continue;
+ 
+			Message_Desc desc;
+			desc.message = applied.text;
+			desc.text_start_x = applied.text_start_x;
+			desc.text_start_y = applied.text_start_y;
+			desc.font_path = applied.font_path;
+			desc.font_size = applied.font_size;
+			desc.dynamic_static = applied.dynamic_static;
+ 
+			message_descs.push_back(std::move(desc));
+			created_handles.push_back(applied.handle);
+		}
+		if (!message_descs.empty())
+		{
+			std::vector<unsigned> message_indices = create_text_messages(message_descs);
+ 
+			for (unsigned i = 0; i < message_indices.size(); ++i)
+			{
+				if (created_handles[i] >= handle_messages.size())
+					handle_messages.resize(created_handles[i] + 1, UINT_MAX);
+				handle_messages[created_handles[i]] = message_indices[i];
+			}
+		}
+ 
+		// (2) Edits & removals, in submission order
+		// -----------------------------------------------------
+		for (size_t c = 0; c < applied_commands.size(); ++c)
+		{
+			const Text_Command& applied = applied_commands[c];
+			if (applied.type == Text_Command_Type::create)
+				continue;
+ 
+			unsigned message_index = command_message_index(applied.handle);
+			if (message_index == UINT_MAX)
+			{
+				std::cout << "\n   Warning: apply_text_commands() --- handle " << applied.handle << " has no message (never created, or already removed)";
+				continue;
+			}
+			if (applied.type == Text_Command_Type::remove)
+			{
+				remove_message(message_index);
+				handle_messages[applied.handle] = UINT_MAX;
+			}
+			else if (last_handle_command[applied.handle] == c) // Otherwise replaced (or removed) later this frame.
+				set_message_text(message_index, applied.text);
+		}
+	}
+ 
+	// Async mode: the font is opened & rasterised on a worker thread, while the message draws placeholder boxes...
+	// update_async_uploads() must then be called once per frame to stream the alphabet in, and to lay out the real glyphs.
+	void create_text_message_async(std::string message, int text_start_x, int text_start_y, std::string font_path, int font_size, bool dynamic_static)
+	{
+		int alphabet_detected = -1;
+		for (unsigned i = 0; i < messages.size(); ++i)
+		{
+			if (messages[i].font_size == font_size && messages[i].font_path == font_path && messages[i].fallback_font_paths == fallback_font_paths)
+			{
+				alphabet_detected = (int)i;
+				break;
+			}
+		}
+		if (alphabet_detected != -1 && !messages[alphabet_detected].glyphs_pending) // The alphabet already exists, so there is nothing to wait for.
+		{
+			create_text_message(message, text_start_x, text_start_y, font_path, font_size, dynamic_static);
+			return;
+		}
+		Message_Parent new_message(&message_arena);
+ 
+		new_message.font_size = font_size;
+		new_message.font_path = font_path;
+		new_message.fallback_font_paths = fallback_font_paths;
+		new_message.alphabet_characters = alphabet_codepoints;
+		new_message.glyph_pixel_scale = 1.0f / dpi_scale;
+		new_message.message_string.assign(message.data(), message.size());
+		new_message.dynamic_static = dynamic_static;
+		new_message.requested_start_x = text_start_x;
+		new_message.requested_start_y = text_start_y;
+		new_message.glyphs_pending = true;
+		new_message.draw_alphabet = false; // The alphabet preview quad is only created for synchronously loaded alphabets.
+ 
+		if (alphabet_detected == -1) // Start rasterising a new alphabet on a worker thread.
+			new_message.alphabet_upload = start_alphabet_rasterisation(new_message);
+		else // Wait on the alphabet that is already being loaded.
+			new_message.alphabet_upload = messages[alphabet_detected].alphabet_upload;
+ 
+		process_placeholder_boxes(new_message);
+		initialise_buffer_data_message(new_message);
+		update_buffer_data_message(new_message, 0);
+ 
+		store_message(new_message);
+	}
+ 
+	// Async mode without a message: starts loading the alphabet for "font_path" & "font_size" (unless it exists, or is already loading), as an alphabet-only entry
+	// that later messages copy from (as with: warm_up_from_profile(...))... it arrives through update_async_uploads(), see: alphabet_ready(...)
+	void preload_alphabet_async(std::string font_path, int font_size)
+	{
+		for (const Message_Parent& message : messages)
+			if (message.font_size == font_size && message.font_path == font_path && message.fallback_font_paths == fallback_font_paths)
+				return;
+ 
+		Message_Parent new_message(&message_arena);
+ 
+		new_message.font_size = font_size;
+		new_message.font_path = font_path;
+		new_message.fallback_font_paths = fallback_font_paths;
+		new_message.alphabet_characters = alphabet_codepoints;
+		new_message.glyph_pixel_scale = 1.0f / dpi_scale;
+		new_message.glyphs_pending = true;
+		new_message.draw_alphabet = false;
+		new_message.alphabet_upload = start_alphabet_rasterisation(new_message);
+ 
+		initialise_buffer_data_message(new_message); // Empty buffer... keeps draw_messages() valid for this entry.
+		messages.push_back(std::move(new_message));
+	}
+ 
+	// True once messages using "font_path" & "font_size" can be created without rasterising (or waiting on) their alphabet.
+	bool alphabet_ready(const std::string& font_path, int font_size)
+	{
+		return find_alphabet(messages, font_path, font_size) != -1;
+	}
+ 
+	// Call once per frame (before drawing)... no frame uploads more than "atlas_upload_budget_bytes" of alphabet texture data.
+	void update_async_uploads()
+	{
+		size_t frame_budget_bytes = atlas_upload_budget_bytes;
+ 
+		for (unsigned i = 0; i < messages.size(); ++i)
+		{
+			if (!messages[i].glyphs_pending)
+				continue;
+ 
+			Alphabet_Upload& upload = *messages[i].alphabet_upload;
+			if (upload.rasterized)
+			{
+				if (!Job_System::finished(upload.rasterized))
+					continue; // Still rasterising... keep drawing the placeholder.
+ 
+				upload.rasterized.reset();
+				begin_alphabet_upload(upload);
+			}
+			stream_alphabet_upload(upload, frame_budget_bytes);
+ 
+			if (upload.rows_uploaded == upload.alphabet_texture_height)
+				finish_async_message(messages[i]);
+		}
+		for (size_t r = 0; r < alphabet_rescales.size();) // DPI changes... see: set_dpi_scale(...)
+		{
+			Alphabet_Rescale& rescale = alphabet_rescales[r];
+			Alphabet_Upload& upload = *rescale.upload;
+ 
+			if (upload.rasterized)
+			{
+				if (!Job_System::finished(upload.rasterized))
+				{
+					++r;
+					continue;
+				}
+				upload.rasterized.reset();
+				begin_alphabet_upload(upload);
+			}
+			stream_alphabet_upload(upload, frame_budget_bytes);
+ 
+			if (upload.rows_uploaded < upload.alphabet_texture_height)
+			{
+				++r;
+				continue;
+			}
+			if (rescale.settings.glyph_pixel_scale != 1.0f / dpi_scale) // The scale changed again while rasterising.
+			{
+				renderer.delete_texture(upload.alphabet_texture);
+ 
+				if (rescale.old_glyph_pixel_scale != 1.0f / dpi_scale)
+				{
+					rescale.settings.glyph_pixel_scale = 1.0f / dpi_scale;
+					rescale.upload = start_alphabet_rasterisation(rescale.settings);
+					++r;
+					continue;
+				}
+			}
+			else
+				finish_alphabet_rescale(rescale);
+ 
+			alphabet_rescales.erase(alphabet_rescales.begin() + r);
+		}
+	}
+ 
+	void draw_alphabets()
+	{
+		renderer.begin_quads();
+ 
+		for (unsigned i = 0; i < messages.size(); ++i)
+		{
+			if (messages[i].draw_alphabet)
+			{
+				renderer.draw_quads(messages[i].VAO_alphabet, messages[i].alphabet_texture, 0, 1, glm::vec2(0.0f));
+				// std::cout << "\n   Drawing alphabet... messages index: " << i;
+			}
+		}
+		renderer.end_quads();
+	}
+ 
+	// Immediate mode: queues "text" for this frame only (no quad buffer is created)... the queued text is drawn by: draw_immediate_text()
+	void draw_text(const std::string& text, int text_start_x, int text_start_y, const std::string& font_path, int font_size)
+	{
+		if (!immediate_frame)
+			immediate_frame = std::make_unique<Immediate_Frame>(64 * 1024);
+ 
+		int layout_index = find_alphabet(immediate_layouts, font_path, font_size);
+		if (layout_index == -1)
+		{
+			Message_Parent layout; // Default (heap) allocator, as it outlives every frame.
+			prepare_layout_alphabet(layout, font_path, font_size);
+			layout.draw_alphabet = false;
+ 
+			immediate_layouts.push_back(std::move(layout));
+			layout_index = (int)immediate_layouts.size() - 1;
+		}
+		Message_Parent& layout = immediate_layouts[layout_index];
+ 
+		layout.message_string.assign(text.data(), text.size()); // Capacity is kept between calls, so these stop allocating once warm.
+		layout.characters_quads.clear();
+		layout.start_x_current.clear();
+		layout.quad_character.clear();
+		process_text_compare(layout, text_start_x, text_start_y);
+ 
+		if (layout.characters_quads.empty())
+			return;
+ 
+		Immediate_Text queued;
+		queued.alphabet_texture = layout.alphabet_texture;
+		queued.first_quad = (unsigned)immediate_frame->quads.size();
+		queued.quad_count = (unsigned)layout.characters_quads.size();
+ 
+		immediate_frame->quads.insert(immediate_frame->quads.end(), layout.characters_quads.begin(), layout.characters_quads.end());
+		immediate_frame->texts.push_back(queued);
+	}
+ 
+	// Uploads this frame's draw_text(...) quads in 1 go, draws them with 1 draw call per alphabet texture, then resets the frame arena... call once per frame.
+	void draw_immediate_text()
+	{
+		if (!immediate_frame || immediate_frame->texts.empty())
+			return;
+ 
+		Immediate_Frame& frame = *immediate_frame;
+ 
+		// Group by alphabet texture (ties keep their draw_text(...) order)
+		std::sort(frame.texts.begin(), frame.texts.end(), [](const Immediate_Text& a, const Immediate_Text& b)
+			{ return a.alphabet_texture != b.alphabet_texture ? a.alphabet_texture < b.alphabet_texture : a.first_quad < b.first_quad; });
+ 
+		if (VAO_immediate == 0)
+			renderer.create_quad_buffer(VAO_immediate, VBO_immediate, 0, nullptr, Text_Buffer_Usage::stream_draw);
+ 
+		size_t upload_bytes = frame.quads.size() * sizeof(Message_Characters);
+		if (upload_bytes > immediate_buffer_bytes)
+			immediate_buffer_bytes = upload_bytes + upload_bytes / 2; // 50% headroom, so a slowly growing overlay doesn't reallocate every frame.
+ 
+		renderer.allocate_quad_buffer(VBO_immediate, immediate_buffer_bytes, Text_Buffer_Usage::stream_draw); // Orphan... fresh storage rather than waiting on last frame's draws.
+		Message_Characters* mapped = (Message_Characters*)renderer.map_quad_buffer(VBO_immediate, upload_bytes);
+ 
+		if (!mapped)
+			std::cout << "\n   Warning: draw_immediate_text() --- map_quad_buffer(...) failed, so this frame's immediate text was skipped.";
+		else
+		{
+			unsigned written = 0;
+			for (const Immediate_Text& queued : frame.texts)
+			{
+				std::memcpy(mapped + written, &frame.quads[queued.first_quad], queued.quad_count * sizeof(Message_Characters));
+				written += queued.quad_count;
+			}
+			renderer.unmap_quad_buffer(VBO_immediate);
+			renderer.begin_quads();
+ 
+			unsigned batch_first = 0;
+			for (unsigned i = 0; i < frame.texts.size();)
+			{
+				unsigned alphabet_texture = frame.texts[i].alphabet_texture;
+				unsigned batch_count = 0;
+ 
+				for (; i < frame.texts.size() && frame.texts[i].alphabet_texture == alphabet_texture; ++i)
+					batch_count += frame.texts[i].quad_count;
+ 
+				renderer.draw_quads(VAO_immediate, alphabet_texture, batch_first, batch_count, glm::vec2(0.0f));
+				batch_first += batch_count;
+			}
+			renderer.end_quads();
+		}
+ 
+		// Reset the frame arena... if this frame spilled onto the heap, the next frame gets a buffer big enough for it.
+		size_t frame_bytes = (frame.quads.capacity() * sizeof(Message_Characters) + frame.texts.capacity() * sizeof(Immediate_Text)) * 2;
+		if (frame_bytes > frame.arena_buffer.size())
+			immediate_frame = std::make_unique<Immediate_Frame>(frame_bytes);
+		else
+		{
+			size_t quad_count = frame.quads.size(), text_count = frame.texts.size();
+ 
+			std::pmr::vector<Message_Characters>(&frame.arena).swap(frame.quads);
+			std::pmr::vector<Immediate_Text>(&frame.arena).swap(frame.texts);
+			frame.arena.release();
+ 
+			frame.quads.reserve(quad_count); // Sized from this frame, so the next one (usually much the same) doesn't regrow within the arena.
+			frame.texts.reserve(text_count);
+		}
+	}
+ 
+	// Width, height & line metrics of "text" as laid out by create_text_message(...) (a '\n' starts a new line, spaced as paragraph lines are), without creating any renderer resources... thread-safe.
+	// Uses the alphabet's advances & line spacing once it exists, otherwise the fallback chain's hinted glyph metrics... after a font's 1st call (and for memoised strings) it doesn't allocate.
+	Text_Extent measure_text(const std::string& text, const std::string& font_path, int font_size)
+	{
+		std::lock_guard<std::mutex> measure_lock(measure_mutex);
+ 
+		const Measure_Font& font = find_measure_font(font_path, font_size);
+ 
+		size_t hash = std::hash<std::string_view>()(std::string_view(text));
+		Measure_Memo& memo = measure_memo[(hash ^ (size_t)&font) % 64];
+ 
+		if (memo.font == &font && memo.hash == hash && memo.length == text.size() && std::memcmp(memo.text, text.data(), text.size()) == 0)
+			return memo.extent;
+ 
+		Text_Extent extent;
+		extent.ascender = font.ascender;
+		extent.descender = font.descender;
+		extent.line_height = font.line_height;
+		extent.line_count = 1;
+ 
+		int line_width = 0;
+		for (size_t i = 0; i < text.size();)
+		{
+			if (text[i] == '\n')
+			{
+				extent.width = std::max(extent.width, line_width);
+				line_width = 0;
+				++extent.line_count;
+				++i;
+			}
+			else if ((unsigned char)text[i] < 0x80)
+				line_width += font.advance[(unsigned char)text[i++]];
+			else
+				line_width += font.advance_of(decode_utf8(text.data(), text.size(), i));
+		}
+		extent.width = std::max(extent.width, line_width);
+		extent.height = (extent.line_count - 1) * font.line_height + font.ascender - font.descender;
+ 
+		if (text.size() <= sizeof(memo.text))
+		{
+			memo.font = &font;
+			memo.hash = hash;
+			memo.length = (unsigned)text.size();
+			std::memcpy(memo.text, text.data(), text.size());
+			memo.extent = extent;
+		}
+		return extent;
+	}
+ 
+	// Caret & hit-test queries (for text fields & clickable labels)... each is a binary search over 1 line's glyph positions, plus O(1) (or O(log lines)) to find the line.
+	// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+	// The caret just before "character_index" (0 to the message's length) as a zero-width rectangle spanning its line.
+	Text_Rect caret_rect(unsigned message_index, unsigned character_index)
+	{
+		const Message_Parent& message = messages[message_index];
+		if (!queryable(message))
+			return Text_Rect{};
+ 
+		Query_Line line = query_line(message, query_line_of_character(message, character_index));
+		float x = caret_x(message, line, character_index);
+ 
+		return line_rect(message, line, x, x);
+	}
+ 
+	// The caret index nearest the pixel (x, y)... i.e. where a click there would place the caret.
+	unsigned character_at_point(unsigned message_index, int x, int y)
+	{
+		const Message_Parent& message = messages[message_index];
+		if (!queryable(message))
+			return 0;
+ 
+		Query_Line line = query_line(message, query_line_at_y(message, y));
+		if (line.quad_count == 0)
+			return line.first_character;
+ 
+		const float* start_x = nullptr;
+		const unsigned* quad_character = nullptr;
+		float offset_x = 0.0f;
+		query_arrays(message, start_x, quad_character, offset_x);
+ 
+		float point_x = x - offset_x;
+ 
+		const float* line_begin = start_x + line.first_quad;
+		const float* line_end = line_begin + line.quad_count;
+		unsigned after = (unsigned)(std::upper_bound(line_begin, line_end, point_x) - start_x); // 1st glyph starting right of the point.
+ 
+		if (after == line.first_quad)
+			return line.first_character;
+ 
+		unsigned glyph = after - 1; // The glyph under (or left of) the point... its nearer edge decides.
+		float middle = (start_x[glyph] + glyph_end_x(message, glyph, start_x, quad_character)) * 0.5f;
+ 
+		if (point_x < middle)
+			return quad_character[glyph];
+ 
+		size_t after_glyph = quad_character[glyph];
+		decode_utf8(message.message_string.data(), message.message_string.size(), after_glyph); // Steps over the whole UTF-8 sequence.
+ 
+		return std::min((unsigned)after_glyph, line.end_caret);
+	}
+ 
+	// 1 rectangle per line covered by the characters [first_character, end_character), appended to "rects"
+	void selection_rects(unsigned message_index, unsigned first_character, unsigned end_character, std::vector<Text_Rect>& rects)
+	{
+		const Message_Parent& message = messages[message_index];
+		if (!queryable(message) || first_character >= end_character)
+			return;
+ 
+		unsigned first_line = query_line_of_character(message, first_character);
+		unsigned last_line = query_line_of_character(message, end_character - 1);
+ 
+		for (unsigned n = first_line; n <= last_line; ++n)
+		{
+			Query_Line line = query_line(message, n);
+ 
+			float left = caret_x(message, line, std::max(first_character, line.first_character));
+			float right = caret_x(message, line, std::min(end_character, line.end_caret));
+ 
+			rects.push_back(line_rect(message, line, left, right));
+		}
+	}
+ 
+	// True if the pixel (x, y) is over the message's text (within a line's box, between its 1st & last caret positions)
+	bool message_contains_point(unsigned message_index, int x, int y)
+	{
+		const Message_Parent& message = messages[message_index];
+		if (!queryable(message))
+			return false;
+ 
+		Query_Line line = query_line(message, query_line_at_y(message, y));
+		Text_Rect bounds = line_rect(message, line, caret_x(message, line, line.first_character), caret_x(message, line, line.end_caret));
+ 
+		return x >= bounds.x && x <= bounds.x + bounds.width && y >= bounds.y && y <= bounds.y + bounds.height;
+	}
+ 
+	void draw_messages()
+	{
+		renderer.begin_quads();
+ 
+		for (unsigned i = 0; i < messages.size(); ++i)
+			if (!messages[i].removed)
+				draw_message(messages[i]);
+ 
+		renderer.end_quads();
+	}
+ 
+	void draw_messages(unsigned message_index)
+	{		
+		if (message_index > messages.size() - 1)
+		{
+			std::cout << "\n   Warning: draw_messages(...) --- 'message_index' is greater than 'messages.size() - 1'\n";
+ 
+			int keep_console_open;			
+			std::cin >> keep_console_open;
+		}
+		else if (!messages[message_index].removed)
+		{
+			renderer.begin_quads();
+			draw_message(messages[message_index]);
+			renderer.end_quads();
+		}
+	}
+ 
+	// Scalar quad builder (used for the last 1-3 glyphs of a batch, or for the whole message when SSE2 is unavailable)... writes straight into the pre-sized "characters_quads"
+	void process_text_index(Message_Parent& new_message, unsigned index, float advanced_current, unsigned quad_index)
+	{		
+		// Y-Values (by default the characters are bottom aligned) ("new_message.text_start_x & text_start_y"  are set in: process_text_compare(...))
+		// ---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		const Alphabet_Metrics& metrics = *new_message.alphabet_metrics;
+ 
+		float bottom_bearing = metrics.bottom_bearing[index];
+		float y_pos_aligned = new_message.text_start_y - bottom_bearing;
+		float height = metrics.height_plus_padding[index];
+ 
+		float texcoord_top_y = metrics.texcoord(index, 3);
+		float texcoord_bottom_y = metrics.texcoord(index, 1);
+ 
+		// X-Values
+		// -----------		
+		float start_x_current = new_message.text_start_x + advanced_current;
+		float left_bearing = metrics.left_bearing[index];
+		float width = metrics.width_plus_padding[index];
+ 
+		float texcoord_left_x = metrics.texcoord(index, 0);
+		float texcoord_right_x = metrics.texcoord(index, 2);
+ 
+		Message_Characters quad{};
+ 
+		// Triangle 1
+		// -------------
+		quad.bottom_left_tr1.x = start_x_current + left_bearing;
+ 
+		// Used for replacing characters from some index position, to the end of the full message length
+		// ---------------------------------------------------------------------------------------------------------------------------
+		new_message.start_x_current[quad_index] = start_x_current; // Record the character's start position... but excluding: left_bearing	
+ 
+		quad.bottom_left_tr1.y = y_pos_aligned;
+		quad.bottom_left_tr1.z = texcoord_left_x;
+		quad.bottom_left_tr1.w = texcoord_top_y; // Y-axis texture coordinates are reversed.
+ 
+		quad.bottom_right_tr1.x = start_x_current + left_bearing + width;
+		quad.bottom_right_tr1.y = y_pos_aligned;
+		quad.bottom_right_tr1.z = texcoord_right_x;
+		quad.bottom_right_tr1.w = texcoord_top_y;
+ 
+		quad.top_left_tr1.x = start_x_current + left_bearing;
+		quad.top_left_tr1.y = y_pos_aligned + height;
+		quad.top_left_tr1.z = texcoord_left_x;
+		quad.top_left_tr1.w = texcoord_bottom_y;
+ 
+		// Triangle 2
+		// -------------
+		quad.top_left_tr2.x = start_x_current + left_bearing;
+		quad.top_left_tr2.y = y_pos_aligned + height;
+		quad.top_left_tr2.z = texcoord_left_x;
+		quad.top_left_tr2.w = texcoord_bottom_y;
+ 
+		quad.top_right_tr2.x = start_x_current + left_bearing + width;
+		quad.top_right_tr2.y = y_pos_aligned + height;
+		quad.top_right_tr2.z = texcoord_right_x;
+		quad.top_right_tr2.w = texcoord_bottom_y;
+ 
+		quad.bottom_right_tr2.x = start_x_current + left_bearing + width;
+		quad.bottom_right_tr2.y = y_pos_aligned;
+		quad.bottom_right_tr2.z = texcoord_right_x;
+		quad.bottom_right_tr2.w = texcoord_top_y;
+		// --------------------------------------------------------------
+		// std::cout << "\n   CHARACTER: " << new_message.message_string.c_str()[index] << " --- start_x_current: " << start_x_current << " --- y_pos_aligned: " << y_pos_aligned << " --- width: " << width << " --- height: " << height;
+		// std::cout << "\n  texcoord_left_x: " << texcoord_left_x;
+		// std::cout << "\n   texcoord_right_x: " << texcoord_right_x << "\n";
+ 
+		new_message.characters_quads[quad_index] = quad;		
+	}	
+ 
+	void update_buffer_data_message(Message_Parent& new_message, int characters_offset)
+	{
+		if (new_message.glyph_run || new_message.batch_buffer)
+		{
+			std::cout << "\n   Warning: update_buffer_data_message(...) --- the message shares its buffer (static glyph run or batch)... create it as dynamic to edit its quads.";
+			return;
+		}
+		if (new_message.characters_quads.empty()) // None of its characters are in the alphabet (or it's empty), so its buffer is empty too.
+			return;
+ 
+		long long data_offset_bytes = (long long)characters_offset * 6 * 4 * sizeof(float);
+		long long replace_size_bytes = (new_message.characters_quads.size() * 6 * 4 * sizeof(float)) - data_offset_bytes;
+ 
+		if (data_offset_bytes + replace_size_bytes > (unsigned)new_message.allocated_memory_bytes)
+		{			
+			std::cout << "\n   Warning: update_buffer_data_message(...) --- 'data_offset_bytes' " << data_offset_bytes << " + 'replace_size_bytes' " << replace_size_bytes << " was too large for 'allocated_memory_bytes' "
+				<< new_message.allocated_memory_bytes << " --- so 'replace_size_bytes' has been reduced to: ";
+ 
+			replace_size_bytes -= (data_offset_bytes + replace_size_bytes) - new_message.allocated_memory_bytes;
+			std::cout << replace_size_bytes;
+		}
+		if (data_offset_bytes + replace_size_bytes < (unsigned)new_message.allocated_memory_bytes)
+		{
+			std::cout << "\n   Warning: update_buffer_data_message(...) --- 'data_offset_bytes' " << data_offset_bytes << " + 'replace_size_bytes' " << replace_size_bytes << " is less than 'allocated_memory_bytes' "
+				<< new_message.allocated_memory_bytes << " --- so 'characters_offset' " << characters_offset << " has been reduced to: ";
+ 
+			characters_offset -= (int)((new_message.allocated_memory_bytes - (data_offset_bytes + replace_size_bytes)) / 6 / 4 / sizeof(float));
+			std::cout << characters_offset;
+		}
+		int keep_console_open;
+		if (characters_offset == -1)
+			std::cin >> keep_console_open;
+ 
+		renderer.update_quad_buffer(new_message.VBO_message, (size_t)data_offset_bytes, (size_t)replace_size_bytes, &new_message.characters_quads[characters_offset]);
+	}
+ 
+private:
+	void set_font_parameters(Message_Parent& new_message, Face_Chain& chain)
+	{	
+		FT_Error error_code{};
+		int keep_console_open;
+ 
+		FT_Face primary_face = nullptr;
+		{
+			std::lock_guard<std::mutex> free_type_lock(free_type_mutex);
+			error_code = FT_New_Face(free_type, new_message.font_path.c_str(), 0, &primary_face);
+		}
+		if (error_code)
+		{
+			std::cout << "\n\n   Error code: " << error_code << " --- " << "Could not open font: " << new_message.font_path.c_str();
+			std::cin >> keep_console_open;
+		}
+		error_code = FT_Set_Pixel_Sizes(primary_face, 0, raster_font_size(new_message));
+		if (error_code)
+		{
+			std::cout << "\n\n   Error code: " << error_code << " --- " << "Could not set font pixel size : " << new_message.font_size;
+			std::cin >> keep_console_open;
+		}
+		if (!chain.private_faces)
+			face = primary_face; // Resources are freed in main()
+ 
+		chain.faces.assign(1, primary_face);
+		chain.key = new_message.font_path;
+ 
+		for (unsigned i = 0; i < new_message.fallback_font_paths.size(); ++i)
+		{
+			const std::string& fallback_path = new_message.fallback_font_paths[i];
+			FT_Face fallback_face = nullptr;
+ 
+			if (chain.private_faces || fallback_faces.find(fallback_path) == fallback_faces.end())
+			{
+				{
+					std::lock_guard<std::mutex> free_type_lock(free_type_mutex);
+					error_code = FT_New_Face(free_type, fallback_path.c_str(), 0, &fallback_face);
+				}
+				if (error_code)
+				{
+					std::cout << "\n\n   Error code: " << error_code << " --- " << "Could not open fallback font: " << fallback_path.c_str();
+					std::cin >> keep_console_open;
+					continue;
+				}
+				if (!chain.private_faces)
+					fallback_faces[fallback_path] = fallback_face;
+			}
+			else
+				fallback_face = fallback_faces[fallback_path];
+ 
+			error_code = FT_Set_Pixel_Sizes(fallback_face, 0, raster_font_size(new_message)); // The shared face is resized for each new alphabet.
+			if (error_code)
+			{
+				std::cout << "\n\n   Error code: " << error_code << " --- " << "Could not set fallback font pixel size : " << new_message.font_size;
+				std::cin >> keep_console_open;
+			}
+			chain.faces.push_back(fallback_face);
+			chain.key += "|" + fallback_path;
+		}
+	}
+ 
+	int raster_font_size(const Message_Parent& new_message) const // "font_size" is in layout pixels... the glyphs are rasterised at the DPI scale the alphabet is made for.
+	{
+		return std::max(1, (int)std::lround(new_message.font_size / new_message.glyph_pixel_scale));
+	}
+ 
+	template <typename T>
+	void write_profile_value(std::ofstream& profile, T value)
+	{
+		profile.write((const char*)&value, sizeof(T));
+	}
+ 
+	void write_profile_string(std::ofstream& profile, const std::string& value) // Length, then the bytes.
+	{
+		write_profile_value(profile, (unsigned)value.size());
+		profile.write(value.data(), value.size());
+	}
+ 
+	template <typename T>
+	T read_profile_value(std::ifstream& profile)
+	{
+		T value{};
+		profile.read((char*)&value, sizeof(T));
+		return value;
+	}
+ 
+	void close_face_chain(Face_Chain& chain)
+	{
+		if (!chain.private_faces)
+			return; // Shared faces are freed in main()
+ 
+		std::lock_guard<std::mutex> free_type_lock(free_type_mutex);
+		for (unsigned i = 0; i < chain.faces.size(); ++i)
+			FT_Done_Face(chain.faces[i]);
+ 
+		chain.faces.clear();
+	}
+ 
+	// Returns the first face in the chain containing "codepoint"... FT_Get_Char_Index(...) is only called across the faces once per chain & codepoint.
+	Glyph_Source resolve_codepoint(Face_Chain& chain, unsigned long codepoint)
+	{
+		std::lock_guard<std::mutex> cache_lock(fallback_cache_mutex);
+		std::unordered_map<unsigned long, Glyph_Source>& chain_cache = fallback_cache[chain.key];
+ 
+		std::unordered_map<unsigned long, Glyph_Source>::iterator cached = chain_cache.find(codepoint);
+		if (cached != chain_cache.end())
+			return cached->second;
+ 
+		Glyph_Source source{};
+		for (unsigned i = 0; i < chain.faces.size(); ++i)
+		{
+			FT_UInt glyph_index = FT_Get_Char_Index(chain.faces[i], codepoint);
+			if (glyph_index != 0)
+			{
+				source.face_index = (int)i;
+				source.glyph_index = glyph_index;
+				break;
+			}
+		}
+		chain_cache[codepoint] = source;
+		return source;
+	}
+ 
+	// Replaces FT_Load_Char(face, ...) so that the glyph is loaded from whichever face in the chain supplies it.
+	FT_Error load_alphabet_glyph(Face_Chain& chain, unsigned long codepoint)
+	{
+		Glyph_Source source = resolve_codepoint(chain, codepoint);
+ 
+		FT_Error error_code = FT_Load_Glyph(chain.faces[source.face_index], source.glyph_index, FT_LOAD_RENDER);
+		chain.glyph = chain.faces[source.face_index]->glyph; // "glyph" now points at the supplying face's glyph slot.
+ 
+		return error_code;
+	}
+ 
+	// Returns the index of a message (below "search_limit") whose alphabet matches, or -1... alphabets still loading asynchronously are skipped.
+	int find_alphabet(const std::vector<Message_Parent>& message_list, const std::string& font_path, int font_size, unsigned search_limit = UINT_MAX)
+	{
+		for (unsigned i = 0; i < message_list.size() && i < search_limit; ++i)
+		{
+			if (message_list[i].font_size == font_size && message_list[i].font_path == font_path && message_list[i].fallback_font_paths == fallback_font_paths && !message_list[i].glyphs_pending)
+				return (int)i;
+		}
+		return -1;
+	}
+ 
+	// Gives "new_message" its font settings and an alphabet, either copied from "message_list" or newly created.
+	void prepare_message_alphabet(Message_Parent& new_message, const std::vector<Message_Parent>& message_list, const std::string& font_path, int font_size)
+	{
+		int alphabet_detected = find_alphabet(message_list, font_path, font_size);
+ 
+		new_message.font_size = font_size;
+		new_message.font_path = font_path;		
+		new_message.fallback_font_paths = fallback_font_paths;
+		new_message.alphabet_characters = alphabet_codepoints;
+		new_message.glyph_pixel_scale = 1.0f / dpi_scale;
+		
+		if (alphabet_detected == -1) // Create new alphabet.
+		{
+			//std::cout << "\n\n   New alphabet created (characters are listed below) --- Font path: " << font_path << " --- Font size: " << font_size;
+			create_alphabet(new_message);
+		}
+		else // Copy the existing alphabet.
+		{
+			copy_alphabet(new_message, message_list[alphabet_detected]);
+			
+			//std::cout << "\n\n   Existing alphabet detected (no new alphabet is required) --- Font path: " << font_path << " --- Font size: " << font_size << "\n";
+		}
+	}
+ 
+	// As above, for a layout kept outside "messages" (immediate text, documents, logs & terminal grids)... a newly created alphabet is also added to "messages" as an alphabet-only entry,
+	// so that find_alphabet(...) finds it, and later messages with the same font & size copy it rather than rasterising & uploading it again.
+	void prepare_layout_alphabet(Message_Parent& layout, const std::string& font_path, int font_size)
+	{
+		bool alphabet_exists = find_alphabet(messages, font_path, font_size) != -1;
+		prepare_message_alphabet(layout, messages, font_path, font_size);
+ 
+		if (alphabet_exists)
+			return;
+ 
+		Message_Parent alphabet(&message_arena);
+		alphabet.font_size = font_size;
+		alphabet.font_path = font_path;
+		alphabet.fallback_font_paths = fallback_font_paths;
+		copy_alphabet(alphabet, layout);
+ 
+		initialise_buffer_data_message(alphabet); // Empty buffer... keeps draw_messages() valid for this entry.
+		messages.push_back(std::move(alphabet));
+	}
+ 
+	void create_alphabet(Message_Parent& new_message)
+	{
+		Face_Chain chain;
+		set_font_parameters(new_message, chain);
+		renderer.create_atlas_texture(new_message.alphabet_texture);
+		calculate_alphabet_image_size(new_message, chain);
+		format_alphabet_texture_image(new_message, chain);
+		upload_alphabet_texture(new_message);
+		create_alphabet_image_quad(new_message);
+		set_buffer_data_alphabet(new_message);
+	}
+ 
+	void copy_alphabet(Message_Parent& new_message, const Message_Parent& existing_message)
+	{
+		new_message.draw_alphabet = false;
+		new_message.alphabet_characters = existing_message.alphabet_characters;
+		new_message.alphabet_metrics = existing_message.alphabet_metrics;
+		new_message.alphabet_texture = existing_message.alphabet_texture;
+		new_message.alphabet_texture_width = existing_message.alphabet_texture_width;
+		new_message.alphabet_texture_height = existing_message.alphabet_texture_height;
+		new_message.tallest_font_height = existing_message.tallest_font_height;
+		new_message.relative_distance = existing_message.relative_distance;
+		new_message.glyph_pixel_scale = existing_message.glyph_pixel_scale;
+	}
+ 
+	void calculate_alphabet_image_size(Message_Parent& new_message, Face_Chain& chain)
 	{
 		FT_Error error_code{};
  
-		int curr_row_width = 0;
-		int max_row_width = 0;
-		int number_of_rows = 1;
-		int character_count = 0;		
-		
-		new_message.tallest_font_height = 0;
+		int curr_row_width = 0;
+		int max_row_width = 0;
+		int number_of_rows = 1;
+		int character_count = 0;		
+		
+		new_message.tallest_font_height = 0;
+ 
+		for (unsigned i = 0; i < new_message.alphabet_characters.size(); i++)
+		{
+			error_code = load_alphabet_glyph(chain, new_message.alphabet_characters[i]);
+			if (error_code)
+			{
+				std::cout << "\n\n   Error code: " << error_code << " --- " << "Could not load codepoint: " << (unsigned long)new_message.alphabet_characters[i];	
+				int keep_console_open;
+				std::cin >> keep_console_open;
+			}
+			FT_GlyphSlot glyph = chain.glyph;
+			if ((signed)glyph->bitmap.rows > new_message.tallest_font_height)
+				new_message.tallest_font_height = glyph->bitmap.rows;
+ 
+			curr_row_width += glyph->bitmap.width + alphabet_padding * 2;
+ 
+			++character_count;
+			if (character_count == character_row_limit)
+			{
+				character_count = 0;
+				++number_of_rows;				
+ 
+				if (curr_row_width > max_row_width)
+					max_row_width = curr_row_width;
+ 
+				curr_row_width = 0;
+			}
+			new_message.alphabet_texture_width = (curr_row_width > max_row_width) ? curr_row_width : max_row_width;
+			// std::cout << "\n\n   alphabet_texture_width: " << alphabet_texture_width;
+		}		
+		new_message.alphabet_texture_height = number_of_rows * (new_message.tallest_font_height + alphabet_padding * 2);
+ 
+		std::cout << "\n\n   alphabet_texture_width: " << new_message.alphabet_texture_width
+			<< " --- alphabet_texture_height: " << new_message.alphabet_texture_height << "\n";
+	}
+ 
+	// Composes the alphabet image in "alphabet_pixels" without any GL calls (so that async mode can run it on a worker thread)... uploaded in: upload_alphabet_texture()
+	void format_alphabet_texture_image(Message_Parent& new_message, Face_Chain& chain)
+	{
+		// Initialise empty data: https://stackoverflow.com/questions/7195130/how-to-efficiently-initialize-texture-with-zeroes
+		new_message.alphabet_pixels.assign(new_message.alphabet_texture_width * new_message.alphabet_texture_height, 0); // 8 bits = 1 byte per texel.
+		
+		int character_count = 0;
+		int increment_x = alphabet_padding;
+		int increment_y = alphabet_padding;
+		
+		new_message.relative_distance = new_message.tallest_font_height; // Set relative distance to initial value.
+ 
+		std::shared_ptr<Alphabet_Metrics> metrics = std::make_shared<Alphabet_Metrics>(); // Each array gets 1 value per character... used in: process_text_compare()
+ 
+		for (unsigned i = 0; i < new_message.alphabet_characters.size(); ++i)
+		{
+			load_alphabet_glyph(chain, new_message.alphabet_characters[i]); // "glyph" as used below... is shorthand for "face->glyph" (or the fallback face supplying the character)
+			FT_GlyphSlot glyph = chain.glyph;
+ 
+			int tex_coord_left = increment_x - alphabet_padding;				
+				for (unsigned row = 0; row < glyph->bitmap.rows; ++row) // Apply 1 character at a time to the image (the bitmap's "pitch" is its row stride in bytes)
+					memcpy(&new_message.alphabet_pixels[(increment_y + row) * new_message.alphabet_texture_width + increment_x], glyph->bitmap.buffer + row * glyph->bitmap.pitch, glyph->bitmap.width);
+			int tex_coord_right = increment_x + glyph->bitmap.width + alphabet_padding;
+ 
+			int tex_coord_bottom = increment_y - alphabet_padding;
+			int tex_coord_top = increment_y + glyph->bitmap.rows + alphabet_padding;
+ 
+			increment_x += glyph->bitmap.width + (alphabet_padding * 2);
+ 
+			// By default the characters are bottom aligned (Note: bitmap_top = the "Remaining Distance" above that bottom alignment, after having been moved downwards by "bottom_bearing" to produce character-origin alignment)
+			// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+			if (new_message.relative_distance > new_message.tallest_font_height - glyph->bitmap_top)
+				new_message.relative_distance = new_message.tallest_font_height - glyph->bitmap_top; // Record the smallest... Tallest Font - "Remaining Distance" (incidentally, the tallest font is also checked against itself by doing this)
+ 
+			// FT_GlyphSlotRec: https://freetype.org/freetype2/docs/reference/ft2-base_interface.html#ft_glyphslotrec (Also available: https://freetype.org/freetype2/docs/reference/ft2-base_interface.html#ft_glyph_metrics)
+			// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+			metrics->glyph_advance_x.push_back((glyph->advance.x / 64) * new_message.glyph_pixel_scale);
+ 
+			// The values below are in pixels...  FT_Bitmap: https://freetype.org/freetype2/docs/reference/ft2-basic_types.html#ft_bitmap			
+			// --------------------------------------------------------------------------------------------------------------------------------------------------------------------		
+			metrics->left_bearing.push_back(glyph->bitmap_left * new_message.glyph_pixel_scale);
+			metrics->width_plus_padding.push_back((tex_coord_right - tex_coord_left) * new_message.glyph_pixel_scale);
+			metrics->bottom_bearing.push_back(((int)glyph->bitmap.rows - (int)glyph->bitmap_top) * new_message.glyph_pixel_scale);
+			metrics->height_plus_padding.push_back((tex_coord_top - tex_coord_bottom) * new_message.glyph_pixel_scale);
+			char32_t codepoint = new_message.alphabet_characters[i];
+			metrics->codepoint.push_back(codepoint);
+ 
+			if (metrics->glyph_index(codepoint) == -1) // The 1st occurrence wins (as with the original alphabet scan)
+			{
+				if (codepoint < 128)
+					metrics->character_lookup[codepoint] = (int)i;
+				else
+					metrics->codepoint_lookup[codepoint] = (int)i;
+			}
+ 
+			//std::cout << "\n   CHARACTER: " << new_message.alphabet_characters[i] << "\n   glyph->advance.x: " << glyph->advance.x << "\n   glyph->advance.x / 64: " << glyph->advance.x / 64
+				//<< "\n   glyph->bitmap_left: " << glyph->bitmap_left << "\n   glyph->bitmap.width: " << glyph->bitmap.width << "\n   glyph->bitmap.rows: " << glyph->bitmap.rows
+				//<< "\n   bottom bearing (height - top): " << (int)glyph->bitmap.rows - (int)glyph->bitmap_top << "\n   top bearing (bitmap_top): " << glyph->bitmap_top << "\n";
+ 
+			// Texture Coordinates Section (divide texture coordinate position values by texture size to get range [0, 1]... stored as 16-bit normalised values)
+			// ------------------------------------------------------------------------------------------------------------------------------------------
+			metrics->push_texcoord((float)tex_coord_left / (float)new_message.alphabet_texture_width);
+			metrics->push_texcoord((float)tex_coord_bottom / (float)new_message.alphabet_texture_height);
+			metrics->push_texcoord((float)tex_coord_right / (float)new_message.alphabet_texture_width);
+			metrics->push_texcoord((float)tex_coord_top / (float)new_message.alphabet_texture_height);
+ 
+			++character_count;
+			if (character_count == character_row_limit)
+			{
+				character_count = 0;				
+				increment_y += new_message.tallest_font_height + (alphabet_padding * 2);
+				increment_x = alphabet_padding;
+			}
+		}
+		metrics->ascender = (int)(chain.faces[0]->size->metrics.ascender >> 6);
+		metrics->descender = (int)(chain.faces[0]->size->metrics.descender >> 6);
+		metrics->line_height = (int)(chain.faces[0]->size->metrics.height >> 6);
+ 
+		new_message.alphabet_metrics = metrics;
+		register_measure_alphabet(new_message);
+	}	
+ 
+	void upload_alphabet_texture(Message_Parent& new_message)
+	{
+		renderer.upload_atlas_pixels(new_message.alphabet_texture, new_message.alphabet_texture_width, new_message.alphabet_texture_height, &new_message.alphabet_pixels[0]);
+		std::vector<unsigned char>().swap(new_message.alphabet_pixels); // Free the CPU copy (the texture now holds the image)
+	}
+ 
+	void begin_alphabet_upload(Alphabet_Upload& upload)
+	{
+		renderer.create_atlas_texture(upload.alphabet_texture);
+		renderer.upload_atlas_pixels(upload.alphabet_texture, upload.alphabet_texture_width, upload.alphabet_texture_height, nullptr); // Allocate only... rows are streamed in below.
+	}
+ 
+	// Streams whole texture rows through the renderer's staging buffer (a PBO in GL) until "frame_budget_bytes" (shared by every pending alphabet this frame) is used up.
+	void stream_alphabet_upload(Alphabet_Upload& upload, size_t& frame_budget_bytes)
+	{
+		size_t row_bytes = upload.alphabet_texture_width;
+ 
+		while (upload.rows_uploaded < upload.alphabet_texture_height)
+		{
+			int slice_rows = (int)(frame_budget_bytes / row_bytes);
+			if (slice_rows == 0)
+			{
+				if (frame_budget_bytes != atlas_upload_budget_bytes)
+					break; // Continue next frame.
+ 
+				slice_rows = 1; // The budget is smaller than 1 row... send 1 row per frame, otherwise the upload would never finish.
+			}
+			if (slice_rows > upload.alphabet_texture_height - upload.rows_uploaded)
+				slice_rows = upload.alphabet_texture_height - upload.rows_uploaded;
+ 
+			size_t slice_bytes = slice_rows * row_bytes;
+			renderer.upload_atlas_rows(upload.alphabet_texture, upload.staging_buffer, upload.alphabet_texture_width, upload.rows_uploaded, slice_rows, &upload.alphabet_pixels[upload.rows_uploaded * row_bytes]);
+ 
+			upload.rows_uploaded += slice_rows;
+			frame_budget_bytes = (slice_bytes < frame_budget_bytes) ? frame_budget_bytes - slice_bytes : 0;
+		}
+		if (upload.rows_uploaded == upload.alphabet_texture_height && !upload.alphabet_pixels.empty())
+		{
+			renderer.delete_staging_buffer(upload.staging_buffer);
+			std::vector<unsigned char>().swap(upload.alphabet_pixels);
+		}
+	}
+ 
+	void finish_async_message(Message_Parent& new_message)
+	{
+		const Alphabet_Upload& upload = *new_message.alphabet_upload;
+ 
+		new_message.alphabet_metrics = upload.alphabet_metrics;
+		new_message.alphabet_texture = upload.alphabet_texture;
+		new_message.alphabet_texture_width = upload.alphabet_texture_width;
+		new_message.alphabet_texture_height = upload.alphabet_texture_height;
+		new_message.tallest_font_height = upload.tallest_font_height;
+		new_message.relative_distance = upload.relative_distance;
+		new_message.glyphs_pending = false;
+ 
+		if (new_message.removed) // Removed while waiting... only the alphabet is kept.
+			return;
+ 
+		new_message.characters_quads.clear(); // Replace the placeholder boxes with the real glyphs.
+		new_message.start_x_current.clear();
+		new_message.quad_character.clear();
+		process_text_compare(new_message, new_message.requested_start_x, new_message.requested_start_y);
+ 
+		renderer.delete_quad_buffer(new_message.VAO_message, new_message.VBO_message); // The real glyph count can differ from the number of placeholder boxes.
+		initialise_buffer_data_message(new_message);
+		if (!new_message.characters_quads.empty()) // Alphabet-only entries have none, see: preload_alphabet_async(...)
+			update_buffer_data_message(new_message, 0);
+ 
+		if (!new_message.spans.empty())
+			upload_span_attributes(new_message);
+	}
+ 
+	// Rasterises the alphabet "settings" describes (font path & size, fallbacks, characters & glyph pixel scale) as a job... streamed in by: update_async_uploads()
+	std::shared_ptr<Alphabet_Upload> start_alphabet_rasterisation(const Message_Parent& settings)
+	{
+		std::shared_ptr<Alphabet_Upload> upload = std::make_shared<Alphabet_Upload>();
+ 
+		std::shared_ptr<Message_Parent> worker_message = std::make_shared<Message_Parent>(); // Only the font settings are needed (the job's own allocations come from the default heap)
+		worker_message->font_size = settings.font_size;
+		worker_message->font_path = settings.font_path;
+		worker_message->fallback_font_paths = settings.fallback_font_paths;
+		worker_message->alphabet_characters = settings.alphabet_characters;
+		worker_message->glyph_pixel_scale = settings.glyph_pixel_scale;
+ 
+		Job_System::Job_Handle rasterise = submit_alphabet_job(*worker_message);
+ 
+		// A 2nd job moves the result into the upload... the upload's handle is to this one, so it only counts as rasterised once the result is in place.
+		upload->rasterized = jobs().submit([upload_pointer = upload.get(), worker_message]()
+			{
+				upload_pointer->alphabet_pixels.swap(worker_message->alphabet_pixels);
+				upload_pointer->alphabet_metrics = worker_message->alphabet_metrics;
+				upload_pointer->alphabet_texture_width = worker_message->alphabet_texture_width;
+				upload_pointer->alphabet_texture_height = worker_message->alphabet_texture_height;
+				upload_pointer->tallest_font_height = worker_message->tallest_font_height;
+				upload_pointer->relative_distance = worker_message->relative_distance;
+			}, { rasterise });
+		return upload;
+	}
+ 
+	// Rasterises & packs the alphabet "new_message" describes as a job, with its own private face chain (no renderer calls)... "new_message" must stay in place until the job finishes,
+	// after which the render thread creates its texture via: upload_alphabet_job(...)
+	Job_System::Job_Handle submit_alphabet_job(Message_Parent& new_message)
+	{
+		return jobs().submit([this, &new_message]()
+			{
+				Face_Chain chain;
+				chain.private_faces = true;
+ 
+				set_font_parameters(new_message, chain);
+				calculate_alphabet_image_size(new_message, chain);
+				format_alphabet_texture_image(new_message, chain);
+				close_face_chain(chain);
+			});
+	}
+ 
+	void upload_alphabet_job(Message_Parent& new_message) // The renderer half of: create_alphabet(...)
+	{
+		renderer.create_atlas_texture(new_message.alphabet_texture);
+		upload_alphabet_texture(new_message);
+		create_alphabet_image_quad(new_message);
+		set_buffer_data_alphabet(new_message);
+	}
+ 
+	// A DPI change's re-rasterised alphabet has fully arrived: everything drawn from the old alphabet switches to it and is laid out again (same layout-pixel size, sharper glyphs)
+	void finish_alphabet_rescale(const Alphabet_Rescale& rescale)
+	{
+		const Alphabet_Upload& upload = *rescale.upload;
+ 
+		auto take_new_alphabet = [&upload, &rescale](Message_Parent& message)
+			{
+				message.alphabet_metrics = upload.alphabet_metrics;
+				message.alphabet_texture = upload.alphabet_texture;
+				message.alphabet_texture_width = upload.alphabet_texture_width;
+				message.alphabet_texture_height = upload.alphabet_texture_height;
+				message.tallest_font_height = upload.tallest_font_height;
+				message.relative_distance = upload.relative_distance;
+				message.glyph_pixel_scale = rescale.settings.glyph_pixel_scale;
+			};
+ 
+		std::vector<std::shared_ptr<const Glyph_Run>> old_runs; // Laid out against the old metrics, so no longer shareable.
+		for (auto it = glyph_run_cache.begin(); it != glyph_run_cache.end();)
+		{
+			if (it->second->alphabet_metrics == rescale.old_metrics)
+			{
+				old_runs.push_back(it->second);
+				it = glyph_run_cache.erase(it);
+			}
+			else
+				++it;
+		}
+		for (unsigned i = 0; i < messages.size(); ++i)
+		{
+			if (messages[i].alphabet_metrics == rescale.old_metrics && !messages[i].glyphs_pending)
+			{
+				take_new_alphabet(messages[i]);
+				if (!messages[i].removed)
+					relayout_message(i);
+			}
+		}
+		for (Bundle_String& entry : bundle_strings)
+		{
+			if (entry.run->alphabet_metrics != rescale.old_metrics)
+				continue;
+ 
+			const Message_Parent& alphabet = messages[entry.alphabet_message]; // Already switched above.
+			Message_Parent run_message(&message_arena);
+			run_message.font_size = alphabet.font_size;
+			run_message.font_path = alphabet.font_path;
+			run_message.fallback_font_paths = alphabet.fallback_font_paths;
+			copy_alphabet(run_message, alphabet);
+ 
+			share_glyph_run(run_message, entry.run->message_string, 0, 0);
+			entry.run = run_message.glyph_run;
+		}
+		for (Document& document : documents)
+		{
+			if (document.layout.alphabet_metrics != rescale.old_metrics)
+				continue;
+ 
+			take_new_alphabet(document.layout);
+			for (Document_Chunk& chunk : document.chunks)
+				chunk.chunk_index = -1; // Laid out again (into the same buffers) when next drawn.
+		}
+		for (Message_Parent& layout : immediate_layouts)
+			if (layout.alphabet_metrics == rescale.old_metrics)
+				take_new_alphabet(layout); // Laid out every frame anyway.
+ 
+		for (const std::shared_ptr<const Glyph_Run>& run : old_runs)
+		{
+			if (run.use_count() > 1)
+				continue;
+ 
+			unsigned VAO_run = run->VAO_run, VBO_run = run->VBO_run;
+			renderer.delete_quad_buffer(VAO_run, VBO_run);
+		}
+		bool texture_in_use = false; // Logs & terminal grids keep the alphabet they were created with (their quads & glyph tables are never rebuilt)
+		for (const Text_Log& log : logs)
+			texture_in_use = texture_in_use || log.layout.alphabet_texture == rescale.old_texture;
+		for (const Terminal_Grid& grid : terminal_grids)
+			texture_in_use = texture_in_use || grid.layout.alphabet_texture == rescale.old_texture;
+ 
+		if (!texture_in_use)
+		{
+			unsigned old_texture = rescale.old_texture;
+			renderer.delete_texture(old_texture);
+		}
+	}
+ 
+	// Lays a message out again from its text & requested position, once its alphabet has been replaced... its quad count may change, so its buffers are recreated.
+	void relayout_message(unsigned message_index)
+	{
+		Message_Parent& message = messages[message_index];
+ 
+		if (message.glyph_run)
+		{
+			std::shared_ptr<const Glyph_Run> old_run = std::move(message.glyph_run); // Detached first... a message still holding a run is refused its own buffer's upload.
+			std::string text(message.message_string.data(), message.message_string.size());
+			share_glyph_run(message, text, message.requested_start_x, message.requested_start_y);
+ 
+			if (old_run.use_count() == 1) // Neither cached nor shared (its cache key collided), so its buffer is freed with it.
+			{
+				unsigned VAO_run = old_run->VAO_run, VBO_run = old_run->VBO_run;
+				renderer.delete_quad_buffer(VAO_run, VBO_run);
+			}
+			return;
+		}
+		if (message.numeric_capacity > 0) // Same slots & buffer... every slot in use is rewritten.
+		{
+			std::string text(message.message_string.data(), std::min(message.message_string.find('\0'), message.message_string.size()));
+ 
+			position_numeric_message(message);
+			std::fill(message.message_string.begin(), message.message_string.end(), '\0');
+			set_numeric_text(message_index, text.data(), text.size());
+			return;
+		}
+		if (message.batch_buffer) // Leaves the shared batch buffer for a buffer of its own.
+		{
+			release_batch_buffer(message);
+			message.buffer_first_quad = 0;
+		}
+		else
+			renderer.delete_quad_buffer(message.VAO_message, message.VBO_message);
+ 
+		message.characters_quads.clear();
+		message.start_x_current.clear();
+		message.quad_character.clear();
+ 
+		if (message.paragraph)
+		{
+			message.lines.clear();
+			reflow_paragraph(message, UINT_MAX, UINT_MAX, 0);
+		}
+		else
+			process_text_compare(message, message.requested_start_x, message.requested_start_y);
+ 
+		initialise_buffer_data_message(message);
+		if (!message.characters_quads.empty())
+			upload_quad_range(message, 0, (unsigned)message.characters_quads.size());
+ 
+		if (!message.spans.empty())
+			upload_span_attributes(message);
+ 
+		if (message.draw_alphabet)
+		{
+			set_alphabet_quad(message);
+			renderer.update_quad_buffer(message.VBO_alphabet, 0, sizeof(message.alphabet_quad), &message.alphabet_quad);
+		}
+	}
+ 
+	// As in: process_text_compare(...) but aligned to the '0' glyph, rather than to whichever character happens to come 1st (so the field never shifts sideways)
+	void position_numeric_message(Message_Parent& message)
+	{
+		int zero_index = message.alphabet_metrics->glyph_index('0');
+		float left_bearing = zero_index == -1 ? 0.0f : message.alphabet_metrics->left_bearing[zero_index];
+ 
+		message.text_start_x = message.requested_start_x - left_bearing - alphabet_padding * message.glyph_pixel_scale;
+		message.text_start_y = -message.requested_start_y + (message.relative_distance - message.tallest_font_height - alphabet_padding) * message.glyph_pixel_scale;
+	}
+ 
+	// Async mode: 1 faint box per non-space character (approximately sized from the pixel size) until the real glyphs arrive.
+	void process_placeholder_boxes(Message_Parent& new_message)
+	{
+		if (placeholder_texture == 0)
+		{
+			unsigned char placeholder_texel = 60;
+ 
+			renderer.create_atlas_texture(placeholder_texture);
+			renderer.upload_atlas_pixels(placeholder_texture, 1, 1, &placeholder_texel);
+		}
+		new_message.alphabet_texture = placeholder_texture;
+ 
+		float box_width = new_message.font_size * 0.5f;
+		float box_height = new_message.font_size * 0.7f;
+		float box_advance = new_message.font_size * 0.6f;
+ 
+		new_message.text_start_x = (float)new_message.requested_start_x;
+		new_message.text_start_y = (float)-(new_message.requested_start_y + new_message.font_size);
+ 
+		unsigned box = 0; // 1 per character (not per UTF-8 byte)
+		for (unsigned i = 0; i < new_message.message_string.size(); ++i)
+		{
+			if (((unsigned char)new_message.message_string[i] & 0xC0) == 0x80) // UTF-8 continuation byte.
+				continue;
+ 
+			float x = new_message.text_start_x + box++ * box_advance;
+			float y = new_message.text_start_y;
+ 
+			if (new_message.message_string[i] == ' ')
+				continue;
+ 
+			Message_Characters quad{}; // Every corner samples the single placeholder texel.
+			quad.bottom_left_tr1 = glm::vec4(x, y, 0.5f, 0.5f);
+			quad.bottom_right_tr1 = glm::vec4(x + box_width, y, 0.5f, 0.5f);
+			quad.top_left_tr1 = glm::vec4(x, y + box_height, 0.5f, 0.5f);
+ 
+			quad.top_left_tr2 = glm::vec4(x, y + box_height, 0.5f, 0.5f);
+			quad.top_right_tr2 = glm::vec4(x + box_width, y + box_height, 0.5f, 0.5f);
+			quad.bottom_right_tr2 = glm::vec4(x + box_width, y, 0.5f, 0.5f);
+ 
+			new_message.characters_quads.push_back(quad);
+		}
+	}
+ 
+	void create_alphabet_image_quad(Message_Parent& new_message)
+	{	
+		float x = 0.1f * window_width / dpi_scale; // The 1st alphabet goes 10% in from the left, 72.5% of the way down.
+		float y = -0.725f * window_height / dpi_scale;
+ 
+		float margin = 50.0f; // Display each alphabet to the right of the previous one.
+		if (messages.size() > 0)
+		{
+			const Message_Parent& previous = messages[messages.size() - 1];
+			x = previous.alphabet_start_x + previous.alphabet_texture_width * previous.glyph_pixel_scale + margin;
+			y = previous.alphabet_start_y;
+		}
+		new_message.alphabet_start_x = x;
+		new_message.alphabet_start_y = y;
+		set_alphabet_quad(new_message);
+	}
+ 
+	void set_alphabet_quad(Message_Parent& new_message) // At "alphabet_start_x" & "alphabet_start_y", the alphabet texture's size.
+	{
+		float x = new_message.alphabet_start_x;
+		float y = new_message.alphabet_start_y;
+ 
+		float width = new_message.alphabet_texture_width * new_message.glyph_pixel_scale;
+		float height = new_message.alphabet_texture_height * new_message.glyph_pixel_scale;
+ 
+		// Triangle 1
+		// -------------
+		new_message.alphabet_quad.bottom_left_tr1.x = x;
+		new_message.alphabet_quad.bottom_left_tr1.y = y;
+		new_message.alphabet_quad.bottom_left_tr1.z = 0.0f;
+		new_message.alphabet_quad.bottom_left_tr1.w = 1.0f;
+ 
+		new_message.alphabet_quad.bottom_right_tr1.x = x + width;
+		new_message.alphabet_quad.bottom_right_tr1.y = y;
+		new_message.alphabet_quad.bottom_right_tr1.z = 1.0f;
+		new_message.alphabet_quad.bottom_right_tr1.w = 1.0f;
+ 
+		new_message.alphabet_quad.top_left_tr1.x = x;
+		new_message.alphabet_quad.top_left_tr1.y = y + height;
+		new_message.alphabet_quad.top_left_tr1.z = 0.0f;
+		new_message.alphabet_quad.top_left_tr1.w = 0.0f;
+ 
+		// Triangle 2
+		// -------------
+		new_message.alphabet_quad.top_left_tr2.x = x;
+		new_message.alphabet_quad.top_left_tr2.y = y + height;
+		new_message.alphabet_quad.top_left_tr2.z = 0.0f;
+		new_message.alphabet_quad.top_left_tr2.w = 0.0f;
+ 
+		new_message.alphabet_quad.top_right_tr2.x = x + width;
+		new_message.alphabet_quad.top_right_tr2.y = y + height;
+		new_message.alphabet_quad.top_right_tr2.z = 1.0f;
+		new_message.alphabet_quad.top_right_tr2.w = 0.0f;
+ 
+		new_message.alphabet_quad.bottom_right_tr2.x = x + width;
+		new_message.alphabet_quad.bottom_right_tr2.y = y;
+		new_message.alphabet_quad.bottom_right_tr2.z = 1.0f;
+		new_message.alphabet_quad.bottom_right_tr2.w = 1.0f;
+	}	
+ 
+	void set_buffer_data_alphabet(Message_Parent& new_message)
+	{
+		renderer.create_quad_buffer(new_message.VAO_alphabet, new_message.VBO_alphabet, sizeof(new_message.alphabet_quad), &new_message.alphabet_quad, Text_Buffer_Usage::static_draw);
+	}
+ 
+	// Decodes the UTF-8 sequence starting at text[i] and steps "i" past it... malformed or truncated sequences give U+FFFD and step 1 byte.
+	static char32_t decode_utf8(const char* text, size_t size, size_t& i)
+	{
+		unsigned char lead = (unsigned char)text[i];
+ 
+		if (lead < 0x80)
+		{
+			++i;
+			return lead;
+		}
+		unsigned length = (lead >= 0xF0) ? 4 : (lead >= 0xE0) ? 3 : (lead >= 0xC0) ? 2 : 0;
+		char32_t codepoint = (length == 4) ? (lead & 0x07) : (length == 3) ? (lead & 0x0F) : (lead & 0x1F);
+ 
+		if (length == 0 || lead > 0xF4 || i + length > size)
+		{
+			++i;
+			return 0xFFFD;
+		}
+		for (unsigned b = 1; b < length; ++b)
+		{
+			unsigned char continuation = (unsigned char)text[i + b];
+			if ((continuation & 0xC0) != 0x80)
+			{
+				++i;
+				return 0xFFFD;
+			}
+			codepoint = (codepoint << 6) | (continuation & 0x3F);
+		}
+		static const char32_t shortest[5] = { 0, 0, 0x80, 0x800, 0x10000 }; // Overlong encodings are rejected.
+		if (codepoint < shortest[length] || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF))
+		{
+			++i;
+			return 0xFFFD;
+		}
+		i += length;
+		return codepoint;
+	}
+ 
+	// The end of the pure-ASCII run starting at text[i]... checks 16 bytes at a time with SSE2 (a byte's top bit marks it as part of a multi-byte sequence)
+	static size_t ascii_run_end(const char* text, size_t i, size_t end)
+	{
+#ifdef TEXT_GLYPHS_SSE2
+		for (; i + 16 <= end; i += 16)
+		{
+			unsigned non_ascii = (unsigned)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(text + i)));
+			if (non_ascii != 0)
+			{
+				while ((non_ascii & 1) == 0)
+				{
+					non_ascii >>= 1;
+					++i;
+				}
+				return i;
+			}
+		}
+#endif
+		while (i < end && (unsigned char)text[i] < 0x80)
+			++i;
+ 
+		return i;
+	}
+ 
+	// Appends the alphabet index of each character in text[first, end) found in the alphabet to "glyph_indices", and its byte offset to "quad_character"...
+	// ASCII runs are table lookups with branch-free compaction, and only the non-ASCII runs go through the scalar UTF-8 decoder.
+	void collect_glyphs(const Alphabet_Metrics& metrics, const char* text, size_t first, size_t end, std::vector<unsigned>& glyph_indices, std::pmr::vector<unsigned>& quad_character)
+	{
+		size_t glyph_count = glyph_indices.size();
+		size_t character_count = quad_character.size();
+ 
+		glyph_indices.resize(glyph_count + (end - first)); // At most 1 glyph per byte... trimmed below.
+		quad_character.resize(character_count + (end - first));
+ 
+		const int* ascii_lookup = metrics.character_lookup.data();
+		size_t i = first;
+ 
+		while (i < end)
+		{
+			for (size_t ascii_end = ascii_run_end(text, i, end); i < ascii_end; ++i)
+			{
+				int glyph = ascii_lookup[(unsigned char)text[i]];
+				size_t found = (glyph >= 0); // Written every time, kept only when found (characters missing from the alphabet are skipped)
+ 
+				glyph_indices[glyph_count] = (unsigned)glyph;
+				quad_character[character_count] = (unsigned)i;
+				glyph_count += found;
+				character_count += found;
+			}
+			while (i < end && (unsigned char)text[i] >= 0x80)
+			{
+				size_t character_start = i;
+				int glyph = metrics.glyph_index(decode_utf8(text, end, i));
+ 
+				if (glyph != -1)
+				{
+					glyph_indices[glyph_count++] = (unsigned)glyph;
+					quad_character[character_count++] = (unsigned)character_start;
+				}
+			}
+		}
+		glyph_indices.resize(glyph_count);
+		quad_character.resize(character_count);
+	}
+ 
+	void process_text_compare(Message_Parent& new_message, int text_start_x, int text_start_y)
+	{
+		// "relative_distance" and "tallest_character" are fixed values, calculated per message (used here to align the text's highest pixel to the display window's top row of pixels)
+		float tallest_character = new_message.tallest_font_height * new_message.glyph_pixel_scale;
+		float relative_distance = new_message.relative_distance * new_message.glyph_pixel_scale;
+ 
+		new_message.requested_start_x = text_start_x; // Kept for re-laying out the message, see: set_dpi_scale(...)
+		new_message.requested_start_y = text_start_y;
+ 
+		static thread_local std::vector<unsigned> glyph_indices; // Alphabet index of each message character found... reused per thread, so it stops allocating once warm.
+		glyph_indices.clear();
+ 
+		std::vector<unsigned long> used_codepoints; // Only filled while recording glyph usage.
+ 
+		collect_glyphs(*new_message.alphabet_metrics, new_message.message_string.data(), 0, new_message.message_string.size(), glyph_indices, new_message.quad_character);
+ 
+		if (record_glyph_usage)
+		{
+			for (unsigned i = 0; i < glyph_indices.size(); ++i)
+				used_codepoints.push_back(new_message.alphabet_metrics->codepoint[glyph_indices[i]]);
+ 
+			record_message_usage(new_message, used_codepoints);
+		}
+ 
+		if (glyph_indices.empty())
+			return;
+ 
+		// Start X, Y positions are set from the 1st character.
+		// -------------------------------------------------------------
+		// Enable these two lines for 2D window-positioned text
+		// -----------------------------------------------------------------------
+		new_message.text_start_x = text_start_x - new_message.alphabet_metrics->left_bearing[glyph_indices[0]] - alphabet_padding * new_message.glyph_pixel_scale;
+		new_message.text_start_y = -text_start_y + relative_distance - tallest_character - alphabet_padding * new_message.glyph_pixel_scale;
+ 
+		// Enable these two lines instead for 3D animated text
+		// --------------------------------------------------------------------
+		// new_message.text_start_x = -1.35f;
+		// new_message.text_start_y = 0.0f;
+ 
+		unsigned first_quad = (unsigned)new_message.characters_quads.size();
+		new_message.characters_quads.resize(first_quad + glyph_indices.size()); // Preallocated once from the arena... the kernels below write in place.
+		new_message.start_x_current.resize(first_quad + glyph_indices.size());
+ 
+		process_text_quads(new_message, &glyph_indices[0], (unsigned)glyph_indices.size(), first_quad);
+	}
+ 
+	// Greedy line break starting at "first_character"... wraps after the last space that fits, or splits a word wider than the whole line.
+	Paragraph_Line break_paragraph_line(const Message_Parent& message, unsigned first_character)
+	{
+		const Alphabet_Metrics& metrics = *message.alphabet_metrics;
+		const std::pmr::string& text = message.message_string;
+ 
+		Paragraph_Line line;
+		line.first_character = first_character;
+ 
+		float pen_x = 0.0f;
+		float width_trimmed = 0.0f; // Pen position after the last non-space character.
+		unsigned last_space_end = first_character; // Just after the most recent run of spaces (first_character = no space yet)
+		float width_before_space = 0.0f;
+ 
+		for (unsigned i = first_character; i < text.size();) // "i" steps a whole UTF-8 sequence at a time, so every break falls between characters.
+		{
+			if (text[i] == '\n')
+			{
+				line.end_character = line.decision_end = i + 1;
+				line.width = width_trimmed;
+				line.next_width = FLT_MAX;
+				return line;
+			}
+			size_t next = i;
+			int glyph = metrics.glyph_index(decode_utf8(text.data(), text.size(), next));
+			float advance = (glyph == -1) ? 0.0f : metrics.glyph_advance_x[glyph];
+ 
+			if (text[i] == ' ') // Spaces never cause a break.
+			{
+				if (i == 0 || text[i - 1] != ' ')
+					width_before_space = width_trimmed;
+ 
+				pen_x += advance;
+				last_space_end = i + 1;
+				i = (unsigned)next;
+				continue;
+			}
+			if (pen_x + advance > message.paragraph_max_width && i > first_character)
+			{
+				if (last_space_end > first_character) // Wrap the current word onto the next line.
+				{
+					float word_width = pen_x;
+					size_t word_end = i;
+					while (word_end < text.size() && text[word_end] != ' ' && text[word_end] != '\n')
+					{
+						int word_glyph = metrics.glyph_index(decode_utf8(text.data(), text.size(), word_end));
+						word_width += (word_glyph == -1) ? 0.0f : metrics.glyph_advance_x[word_glyph];
+					}
+					line.end_character = last_space_end;
+					line.decision_end = (unsigned)word_end;
+					line.width = width_before_space;
+					line.next_width = word_width;
+				}
+				else // A single word wider than the line... split it here.
+				{
+					line.end_character = i;
+					line.decision_end = (unsigned)next;
+					line.width = width_trimmed;
+					line.next_width = pen_x + advance;
+				}
+				return line;
+			}
+			pen_x += advance;
+			width_trimmed = pen_x;
+			i = (unsigned)next;
+		}
+		line.end_character = line.decision_end = (unsigned)text.size();
+		line.width = width_trimmed;
+		line.next_width = FLT_MAX;
+		return line;
+	}
+ 
+	// An old line can be kept if its break decision did not read any edited character, and its break is still the greedy choice at the current width.
+	bool paragraph_line_reusable(const Message_Parent& message, const Paragraph_Line& line, unsigned edit_start, unsigned edit_old_end)
+	{
+		bool before_edit = line.decision_end < edit_start;
+		bool after_edit = line.first_character >= edit_old_end;
+ 
+		return (before_edit || after_edit) && line.width <= message.paragraph_max_width && line.next_width > message.paragraph_max_width;
+	}
+ 
+	// Rebuilds "lines" & "characters_quads" after the characters [edit_start, edit_old_end) were replaced by (edit_old_end - edit_start + length_change) new ones...
+	// ...unaffected lines are copied (translated only when their row or alignment moved) and the rest are re-broken. Returns the first quad that needs uploading.
+	unsigned reflow_paragraph(Message_Parent& message, unsigned edit_start, unsigned edit_old_end, int length_change)
+	{
+		const Alphabet_Metrics& metrics = *message.alphabet_metrics;
+		const std::pmr::string& text = message.message_string;
+ 
+		std::vector<Paragraph_Line> old_lines;
+		old_lines.swap(message.lines);
+ 
+		std::pmr::vector<Message_Characters> old_quads(message.characters_quads.get_allocator());
+		std::pmr::vector<float> old_start_x(message.start_x_current.get_allocator());
+		std::pmr::vector<unsigned> old_quad_character(message.quad_character.get_allocator());
+		old_quads.swap(message.characters_quads);
+		old_start_x.swap(message.start_x_current);
+		old_quad_character.swap(message.quad_character);
+ 
+		message.characters_quads.reserve(text.size());
+		message.start_x_current.reserve(text.size());
+		message.quad_character.reserve(text.size());
+ 
+		float line_height = (message.tallest_font_height + alphabet_padding) * message.glyph_pixel_scale;
+		float tallest_character = message.tallest_font_height * message.glyph_pixel_scale;
+		float relative_distance = message.relative_distance * message.glyph_pixel_scale;
+ 
+		float paragraph_x = message.requested_start_x - alphabet_padding * message.glyph_pixel_scale;
+		float paragraph_y = -message.requested_start_y + relative_distance - tallest_character - alphabet_padding * message.glyph_pixel_scale;
+ 
+		unsigned first_dirty_quad = UINT_MAX;
+		unsigned old_index = 0;
+		unsigned position = 0;
+ 
+		static thread_local std::vector<unsigned> glyph_indices;
+ 
+		while (position < text.size())
+		{
+			// Find the old line (if any) that now starts at "position"
+			// -----------------------------------------------------------------
+			const Paragraph_Line* reusable = nullptr;
+			unsigned old_line_number = 0;
+ 
+			for (; old_index < old_lines.size(); ++old_index)
+			{
+				const Paragraph_Line& old_line = old_lines[old_index];
+ 
+				if (old_line.first_character >= edit_start && old_line.first_character < edit_old_end)
+					continue; // Started inside the edited characters.
+ 
+				unsigned mapped_start = (old_line.first_character >= edit_old_end) ? old_line.first_character + length_change : old_line.first_character;
+				if (mapped_start < position)
+					continue;
+ 
+				if (mapped_start == position && paragraph_line_reusable(message, old_line, edit_start, edit_old_end))
+				{
+					reusable = &old_line;
+					old_line_number = old_index;
+				}
+				break;
+			}
+			unsigned line_number = (unsigned)message.lines.size();
+			unsigned first_quad = (unsigned)message.characters_quads.size();
+ 
+			if (reusable) // Copy the line's quads (no layout)
+			// ---------------------------------------------------
+			{
+				Paragraph_Line line = *reusable;
+				int shift = (line.first_character >= edit_old_end) ? length_change : 0;
+ 
+				line.first_character += shift;
+				line.end_character += shift;
+				line.decision_end += shift;
+				line.align_offset = paragraph_align_offset(message, line.width);
+ 
+				float offset_x = line.align_offset - reusable->align_offset;
+				float offset_y = -((float)line_number - (float)old_line_number) * line_height;
+ 
+				message.characters_quads.insert(message.characters_quads.end(), old_quads.begin() + line.first_quad, old_quads.begin() + line.first_quad + line.quad_count);
+				message.start_x_current.insert(message.start_x_current.end(), old_start_x.begin() + line.first_quad, old_start_x.begin() + line.first_quad + line.quad_count);
+ 
+				for (unsigned i = line.first_quad; i < line.first_quad + line.quad_count; ++i)
+					message.quad_character.push_back(old_quad_character[i] + shift);
+ 
+				if (offset_x != 0.0f || offset_y != 0.0f)
+				{
+					for (unsigned i = first_quad; i < first_quad + line.quad_count; ++i)
+					{
+						glm::vec4* vertex = &message.characters_quads[i].bottom_left_tr1;
+						for (unsigned v = 0; v < 6; ++v)
+						{
+							vertex[v].x += offset_x;
+							vertex[v].y += offset_y;
+						}
+						message.start_x_current[i] += offset_x;
+					}
+				}
+				if (offset_x != 0.0f || offset_y != 0.0f || first_quad != line.first_quad)
+					first_dirty_quad = std::min(first_dirty_quad, first_quad);
+ 
+				line.first_quad = first_quad;
+				message.lines.push_back(line);
+				position = line.end_character;
+				continue;
+			}
+ 
+			// Break & lay out a new line.
+			// --------------------------------
+			Paragraph_Line line = break_paragraph_line(message, position);
+			line.align_offset = paragraph_align_offset(message, line.width);
+			line.first_quad = first_quad;
+ 
+			glyph_indices.clear();
+			collect_glyphs(metrics, text.data(), line.first_character, line.end_character, glyph_indices, message.quad_character);
+			line.quad_count = (unsigned)glyph_indices.size();
+ 
+			if (line.quad_count > 0)
+			{
+				message.characters_quads.resize(first_quad + line.quad_count);
+				message.start_x_current.resize(first_quad + line.quad_count);
+ 
+				message.text_start_x = paragraph_x + line.align_offset; // process_text_quads(...) lays out from the message's start position.
+				message.text_start_y = paragraph_y - line_number * line_height;
+				process_text_quads(message, &glyph_indices[0], line.quad_count, first_quad);
+			}
+			first_dirty_quad = std::min(first_dirty_quad, first_quad);
+ 
+			message.lines.push_back(line);
+			position = line.end_character;
+		}
+		if (first_dirty_quad == UINT_MAX)
+			first_dirty_quad = (unsigned)message.characters_quads.size(); // Nothing changed (a shorter paragraph simply draws fewer quads)
+ 
+		return first_dirty_quad;
+	}
+ 
+	float paragraph_align_offset(const Message_Parent& message, float line_width)
+	{
+		if (message.paragraph_alignment == Text_Alignment::centre)
+			return (message.paragraph_max_width - line_width) * 0.5f;
+		if (message.paragraph_alignment == Text_Alignment::right)
+			return message.paragraph_max_width - line_width;
+ 
+		return 0.0f;
+	}
+ 
+	// Uploads quads [first_quad, end_quad)... the buffer grows (with 50% headroom) when the message no longer fits, in which case everything is uploaded.
+	void upload_quad_range(Message_Parent& message, unsigned first_quad, unsigned end_quad)
+	{
+		size_t quad_bytes = 6 * 4 * sizeof(float);
+		size_t required_bytes = message.characters_quads.size() * quad_bytes;
+ 
+		if (required_bytes > message.allocated_memory_bytes)
+		{
+			message.allocated_memory_bytes = required_bytes + required_bytes / 2;
+			renderer.allocate_quad_buffer(message.VBO_message, message.allocated_memory_bytes, Text_Buffer_Usage::dynamic_draw);
+ 
+			first_quad = 0;
+			end_quad = (unsigned)message.characters_quads.size();
+		}
+		if (end_quad > first_quad)
+			renderer.update_quad_buffer(message.VBO_message, first_quad * quad_bytes, (end_quad - first_quad) * quad_bytes, &message.characters_quads[first_quad]);
+	}
+ 
+	// Builds the quads for "count" glyphs, 4 at a time with SSE2, followed by the scalar remainder.
+	void process_text_quads(Message_Parent& new_message, const unsigned* glyph_indices, unsigned count, unsigned first_quad)
+	{
+		float advance_to_next_character = 0.0f;
+		unsigned i = 0;
+ 
+#ifdef TEXT_GLYPHS_SSE2
+		for (; i + 4 <= count; i += 4)
+			advance_to_next_character = process_text_quads_sse(new_message, glyph_indices + i, first_quad + i, advance_to_next_character);
+#endif
+		for (; i < count; ++i)
+		{
+			process_text_index(new_message, glyph_indices[i], advance_to_next_character, first_quad + i);
+			advance_to_next_character += new_message.alphabet_metrics->glyph_advance_x[glyph_indices[i]];
+		}
+	}
+ 
+#ifdef TEXT_GLYPHS_SSE2
+	// 4 glyphs per call (1 per SIMD lane)... returns the pen position after the 4th glyph.
+	float process_text_quads_sse(Message_Parent& new_message, const unsigned* glyph, unsigned quad_index, float advanced_current)
+	{
+		const Alphabet_Metrics& metrics = *new_message.alphabet_metrics;
+ 
+		__m128 advance = _mm_setr_ps(metrics.glyph_advance_x[glyph[0]], metrics.glyph_advance_x[glyph[1]], metrics.glyph_advance_x[glyph[2]], metrics.glyph_advance_x[glyph[3]]);
+		__m128 left_bearing = _mm_setr_ps(metrics.left_bearing[glyph[0]], metrics.left_bearing[glyph[1]], metrics.left_bearing[glyph[2]], metrics.left_bearing[glyph[3]]);
+		__m128 width = _mm_setr_ps(metrics.width_plus_padding[glyph[0]], metrics.width_plus_padding[glyph[1]], metrics.width_plus_padding[glyph[2]], metrics.width_plus_padding[glyph[3]]);
+		__m128 bottom_bearing = _mm_setr_ps(metrics.bottom_bearing[glyph[0]], metrics.bottom_bearing[glyph[1]], metrics.bottom_bearing[glyph[2]], metrics.bottom_bearing[glyph[3]]);
+		__m128 height = _mm_setr_ps(metrics.height_plus_padding[glyph[0]], metrics.height_plus_padding[glyph[1]], metrics.height_plus_padding[glyph[2]], metrics.height_plus_padding[glyph[3]]);
+ 
+		// Exclusive prefix sum of the advances (shift & add twice = inclusive sum, minus each lane's own advance), offset by the pen position carried in.
+		// -----------------------------------------------------------------------------------------------------------------------------------------------------------------
+		__m128 inclusive = _mm_add_ps(advance, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(advance), 4)));
+		inclusive = _mm_add_ps(inclusive, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(inclusive), 8)));
+ 
+		__m128 start_x_current = _mm_add_ps(_mm_set1_ps(new_message.text_start_x + advanced_current), _mm_sub_ps(inclusive, advance));
+		_mm_storeu_ps(&new_message.start_x_current[quad_index], start_x_current); // Excluding: left_bearing (as in: process_text_index)
+ 
+		__m128 left = _mm_add_ps(start_x_current, left_bearing);
+		__m128 right = _mm_add_ps(left, width);
+		__m128 bottom = _mm_sub_ps(_mm_set1_ps(new_message.text_start_y), bottom_bearing);
+		__m128 top = _mm_add_ps(bottom, height);
+ 
+		// Each glyph's 16-bit texture rectangle loads as 1 row (left, bottom, right, top)... the transpose turns the 4 rows into 1 register per edge.
+		// -------------------------------------------------------------------------------------------------------------------------------------------------------------
+		__m128 tex_left = load_texcoord_rect_sse(metrics, glyph[0]);
+		__m128 tex_bottom = load_texcoord_rect_sse(metrics, glyph[1]);
+		__m128 tex_right = load_texcoord_rect_sse(metrics, glyph[2]);
+		__m128 tex_top = load_texcoord_rect_sse(metrics, glyph[3]);
+		_MM_TRANSPOSE4_PS(tex_left, tex_bottom, tex_right, tex_top);
+ 
+		// Transpose each corner back to 1 register per vertex (x, y, texcoord x, texcoord y)... Y-axis texture coordinates are reversed.
+		// ------------------------------------------------------------------------------------------------------------------------------------------------
+		__m128 bottom_left[4] = { left, bottom, tex_left, tex_top };
+		__m128 bottom_right[4] = { right, bottom, tex_right, tex_top };
+		__m128 top_left[4] = { left, top, tex_left, tex_bottom };
+		__m128 top_right[4] = { right, top, tex_right, tex_bottom };
+ 
+		_MM_TRANSPOSE4_PS(bottom_left[0], bottom_left[1], bottom_left[2], bottom_left[3]);
+		_MM_TRANSPOSE4_PS(bottom_right[0], bottom_right[1], bottom_right[2], bottom_right[3]);
+		_MM_TRANSPOSE4_PS(top_left[0], top_left[1], top_left[2], top_left[3]);
+		_MM_TRANSPOSE4_PS(top_right[0], top_right[1], top_right[2], top_right[3]);
+ 
+		for (unsigned i = 0; i < 4; ++i)
+		{
+			float* quad = &new_message.characters_quads[quad_index + i].bottom_left_tr1.x; // 6 consecutive glm::vec4 vertices.
+ 
+			_mm_storeu_ps(quad + 0, bottom_left[i]); // Triangle 1
+			_mm_storeu_ps(quad + 4, bottom_right[i]);
+			_mm_storeu_ps(quad + 8, top_left[i]);
+ 
+			_mm_storeu_ps(quad + 12, top_left[i]); // Triangle 2
+			_mm_storeu_ps(quad + 16, top_right[i]);
+			_mm_storeu_ps(quad + 20, bottom_right[i]);
+		}
+		return advanced_current + _mm_cvtss_f32(_mm_shuffle_ps(inclusive, inclusive, _MM_SHUFFLE(3, 3, 3, 3)));
+	}
+ 
+	__m128 load_texcoord_rect_sse(const Alphabet_Metrics& metrics, unsigned index)
+	{
+		__m128i rect_16 = _mm_loadl_epi64((const __m128i*)&metrics.texcoord_rect[index * 4]); // 4 x 16-bit = 64 bits.
+		__m128i rect_32 = _mm_unpacklo_epi16(rect_16, _mm_setzero_si128()); // Zero-extend to 4 x 32-bit.
+ 
+		return _mm_mul_ps(_mm_cvtepi32_ps(rect_32), _mm_set1_ps(1.0f / 65535.0f));
+	}
+#endif
+ 
+	void record_message_usage(const Message_Parent& new_message, std::vector<unsigned long>& used_codepoints)
+	{
+		std::lock_guard<std::mutex> usage_lock(glyph_usage_mutex);
+		Glyph_Usage& usage = glyph_usage[std::make_pair(new_message.font_path, new_message.font_size)];
+ 
+		for (unsigned i = 0; i < used_codepoints.size(); ++i)
+			++usage.codepoint_counts[used_codepoints[i]];
+ 
+		// Each pair of distinct glyphs in the message counts once as "used together"
+		std::sort(used_codepoints.begin(), used_codepoints.end());
+		used_codepoints.erase(std::unique(used_codepoints.begin(), used_codepoints.end()), used_codepoints.end());
  
-		for (unsigned i = 0; i < alphabet_string.size(); i++)
+		for (unsigned i = 0; i < used_codepoints.size(); ++i)
+			for (unsigned i2 = i + 1; i2 < used_codepoints.size(); ++i2)
+				++usage.co_occurrence[std::make_pair(used_codepoints[i], used_codepoints[i2])];
+	}
+ 
+	// Greedy chain: start from the most used glyph, then repeatedly append the unplaced glyph used together most often with the last one placed...
+	// ...ties (and glyphs never used together) fall back to the usage count. Neighbours in this order are packed next to each other in the atlas.
+	std::vector<unsigned long> order_by_co_occurrence(const Glyph_Usage& usage)
+	{
+		std::vector<unsigned long> remaining;
+		for (std::map<unsigned long, unsigned>::const_iterator it = usage.codepoint_counts.begin(); it != usage.codepoint_counts.end(); ++it)
+			remaining.push_back(it->first);
+ 
+		std::vector<unsigned long> ordered;
+		while (!remaining.empty())
 		{
-			error_code = FT_Load_Char(face, alphabet_string[i], FT_LOAD_RENDER);
-			if (error_code)
+			unsigned best_index = 0;
+			unsigned best_together = 0;
+			unsigned best_count = 0;
+ 
+			for (unsigned i = 0; i < remaining.size(); ++i)
 			{
-				std::cout << "\n\n   Error code: " << error_code << " --- " << "Could not load character: " << alphabet_string[i];	
-				int keep_console_open;
-				std::cin >> keep_console_open;
+				unsigned together = 0;
+				if (!ordered.empty())
+				{
+					std::pair<unsigned long, unsigned long> pair = std::minmax(ordered.back(), remaining[i]);
+					std::map<std::pair<unsigned long, unsigned long>, unsigned>::const_iterator found = usage.co_occurrence.find(pair);
+					if (found != usage.co_occurrence.end())
+						together = found->second;
+				}
+				unsigned count = usage.codepoint_counts.at(remaining[i]);
+ 
+				if (together > best_together || (together == best_together && count > best_count))
+				{
+					best_index = i;
+					best_together = together;
+					best_count = count;
+				}
 			}
-			if ((signed)glyph->bitmap.rows > new_message.tallest_font_height)
-				new_message.tallest_font_height = glyph->bitmap.rows;
+			ordered.push_back(remaining[best_index]);
+			remaining.erase(remaining.begin() + best_index);
+		}
+		return ordered;
+	}
  
-			curr_row_width += glyph->bitmap.width + alphabet_padding * 2;
+	struct Query_Line // 1 line as the caret queries see it (a single-line message is 1 line)
+	{
+		unsigned first_character = 0;
+		unsigned end_caret = 0; // The last caret position on the line (before a '\n' that ends it)
+		unsigned first_quad = 0;
+		unsigned quad_count = 0;
+		float baseline_y = 0.0f; // Layout pixels.
+		float empty_x = 0.0f; // The caret's x on a line with no glyphs.
+	};
  
-			++character_count;
-			if (character_count == character_row_limit)
-			{
-				character_count = 0;
-				++number_of_rows;				
+	bool queryable(const Message_Parent& message) const
+	{
+		return message.alphabet_metrics && !message.glyphs_pending; // Placeholder boxes aren't real glyph positions.
+	}
  
-				if (curr_row_width > max_row_width)
-					max_row_width = curr_row_width;
+	// The shared glyph run's arrays (plus the message's offset) or the message's own.
+	void query_arrays(const Message_Parent& message, const float*& start_x, const unsigned*& quad_character, float& offset_x) const
+	{
+		if (message.glyph_run)
+		{
+			start_x = message.glyph_run->start_x_current.data();
+			quad_character = message.glyph_run->quad_character.data();
+			offset_x = message.run_offset.x;
+		}
+		else
+		{
+			start_x = message.start_x_current.data();
+			quad_character = message.quad_character.data();
+			offset_x = 0.0f;
+		}
+	}
  
-				curr_row_width = 0;
-			}
-			new_message.alphabet_texture_width = (curr_row_width > max_row_width) ? curr_row_width : max_row_width;
-			// std::cout << "\n\n   alphabet_texture_width: " << alphabet_texture_width;
-		}		
-		new_message.alphabet_texture_height = number_of_rows * (new_message.tallest_font_height + alphabet_padding * 2);
+	unsigned query_line_count(const Message_Parent& message) const
+	{
+		return (message.paragraph && !message.lines.empty()) ? (unsigned)message.lines.size() : 1;
+	}
  
-		std::cout << "\n\n   alphabet_texture_width: " << new_message.alphabet_texture_width
-			<< " --- alphabet_texture_height: " << new_message.alphabet_texture_height << "\n";
+	float paragraph_line_height(const Message_Parent& message) const
+	{
+		return (message.tallest_font_height + alphabet_padding) * message.glyph_pixel_scale; // As in: reflow_paragraph(...)
 	}
  
-	void format_alphabet_texture_image(Message_Parent& new_message)
+	Query_Line query_line(const Message_Parent& message, unsigned line_number) const
 	{
-		glActiveTexture(GL_TEXTURE31);
-		glBindTexture(GL_TEXTURE_2D, new_message.alphabet_texture);
+		Query_Line query;
+		float baseline_padding = alphabet_padding * message.glyph_pixel_scale; // The glyph quads are padded below the baseline.
+ 
+		if (message.paragraph)
+		{
+			float paragraph_x = message.requested_start_x - alphabet_padding * message.glyph_pixel_scale;
+			float paragraph_y = -message.requested_start_y + (message.relative_distance - message.tallest_font_height - alphabet_padding) * message.glyph_pixel_scale;
  
-		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			query.baseline_y = paragraph_y - line_number * paragraph_line_height(message) + baseline_padding;
+			query.empty_x = paragraph_x;
  
-		// Initialise empty data: https://stackoverflow.com/questions/7195130/how-to-efficiently-initialize-texture-with-zeroes
-		std::vector<GLubyte> empty_data(new_message.alphabet_texture_width * new_message.alphabet_texture_height, 0); // GL_RED = 8 bits = 1 byte.
+			if (message.lines.empty())
+				return query;
  
-		//  https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glTexImage2D.xhtml
-		// "Each element is a single red component. OpenGL converts it to floating point and assembles it to RGBA, by attaching 0 for green and blue, and 1 for alpha. Each component is clamped to the range [0, 1]"
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, new_message.alphabet_texture_width, new_message.alphabet_texture_height, 0, GL_RED, GL_UNSIGNED_BYTE, &empty_data[0]);
-		
-		int character_count = 0;
-		int increment_x = alphabet_padding;
-		int increment_y = alphabet_padding;
-		
-		new_message.relative_distance = new_message.tallest_font_height; // Set relative distance to initial value.
+			const Paragraph_Line& line = message.lines[line_number];
+			query.first_character = line.first_character;
+			query.end_caret = (line.end_character > line.first_character && message.message_string[line.end_character - 1] == '\n') ? line.end_character - 1 : line.end_character;
+			query.first_quad = line.first_quad;
+			query.quad_count = line.quad_count;
+			query.empty_x += line.align_offset;
+			return query;
+		}
+		query.baseline_y = message.text_start_y + baseline_padding;
+		query.empty_x = message.text_start_x;
  
-		for (unsigned i = 0; i < alphabet_string.size(); ++i)
+		if (message.numeric_capacity > 0) // Only the slots in use.
+			query.end_caret = query.quad_count = (unsigned)std::min(message.message_string.find('\0'), (size_t)message.numeric_capacity);
+		else
 		{
-			FT_Load_Char(face, alphabet_string[i], FT_LOAD_RENDER); // "glyph" as used below... is shorthand for "face->glyph"
+			query.end_caret = (unsigned)message.message_string.size();
+			query.quad_count = message.glyph_run ? message.glyph_run->quad_count : (unsigned)message.quad_character.size();
+		}
+		return query;
+	}
  
-			int tex_coord_left = increment_x - alphabet_padding;				
-				glTexSubImage2D(GL_TEXTURE_2D, 0, increment_x, increment_y, glyph->bitmap.width, glyph->bitmap.rows, GL_RED, GL_UNSIGNED_BYTE, glyph->bitmap.buffer); // Apply 1 character at a time to the texture.
-			int tex_coord_right = increment_x + glyph->bitmap.width + alphabet_padding;
+	unsigned query_line_of_character(const Message_Parent& message, unsigned character_index) const
+	{
+		if (!message.paragraph || message.lines.empty())
+			return 0;
  
-			int tex_coord_bottom = increment_y - alphabet_padding;
-			int tex_coord_top = increment_y + glyph->bitmap.rows + alphabet_padding;
+		auto after = std::upper_bound(message.lines.begin(), message.lines.end(), character_index, [](unsigned index, const Paragraph_Line& line) { return index < line.first_character; });
+		return (after == message.lines.begin()) ? 0 : (unsigned)(after - message.lines.begin()) - 1;
+	}
  
-			increment_x += glyph->bitmap.width + (alphabet_padding * 2);
+	unsigned query_line_at_y(const Message_Parent& message, int y) const
+	{
+		if (!message.paragraph || message.lines.empty())
+			return 0;
  
-			// By default the characters are bottom aligned (Note: bitmap_top = the "Remaining Distance" above that bottom alignment, after having been moved downwards by "bottom_bearing" to produce character-origin alignment)
-			// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-			if (new_message.relative_distance > new_message.tallest_font_height - glyph->bitmap_top)
-				new_message.relative_distance = new_message.tallest_font_height - glyph->bitmap_top; // Record the smallest... Tallest Font - "Remaining Distance" (incidentally, the tallest font is also checked against itself by doing this)
+		float line_height = paragraph_line_height(message);
+		float first_line_top = query_line(message, 0).baseline_y + message.alphabet_metrics->ascender * message.glyph_pixel_scale;
+		float point_y = (float)-y;
  
-			// FT_GlyphSlotRec: https://freetype.org/freetype2/docs/reference/ft2-base_interface.html#ft_glyphslotrec (Also available: https://freetype.org/freetype2/docs/reference/ft2-base_interface.html#ft_glyph_metrics)
-			// ----------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
-			Alphabet_Characters alphabet_character{};
-			alphabet_character.glyph_advance_x = (glyph->advance.x / 64) * scale_pixels_x_to_OpenGL;
+		int line_number = (int)std::floor((first_line_top - point_y) / line_height);
+		return (unsigned)std::max(0, std::min(line_number, (int)message.lines.size() - 1));
+	}
  
-			// The values below are in pixels...  FT_Bitmap: https://freetype.org/freetype2/docs/reference/ft2-basic_types.html#ft_bitmap			
-			// --------------------------------------------------------------------------------------------------------------------------------------------------------------------		
-			alphabet_character.left_bearing = glyph->bitmap_left * scale_pixels_x_to_OpenGL;
-			alphabet_character.width_plus_padding = (tex_coord_right - tex_coord_left) * scale_pixels_x_to_OpenGL;
-			alphabet_character.bottom_bearing = ((int)glyph->bitmap.rows - (int)glyph->bitmap_top) * scale_pixels_y_to_OpenGL;
-			alphabet_character.height_plus_padding = (tex_coord_top - tex_coord_bottom) * scale_pixels_y_to_OpenGL;
-			alphabet_character.character = alphabet_string[i];
+	float glyph_end_x(const Message_Parent& message, unsigned quad, const float* start_x, const unsigned* quad_character) const
+	{
+		size_t character = quad_character[quad];
+		int glyph = message.alphabet_metrics->glyph_index(decode_utf8(message.message_string.data(), message.message_string.size(), character));
+		return start_x[quad] + ((glyph == -1) ? 0.0f : message.alphabet_metrics->glyph_advance_x[glyph]);
+	}
  
-			//std::cout << "\n   CHARACTER: " << alphabet_string[i] << "\n   glyph->advance.x: " << glyph->advance.x << "\n   glyph->advance.x / 64: " << glyph->advance.x / 64
-				//<< "\n   glyph->bitmap_left: " << glyph->bitmap_left << "\n   glyph->bitmap.width: " << glyph->bitmap.width << "\n   glyph->bitmap.rows: " << glyph->bitmap.rows
-				//<< "\n   bottom bearing (height - top): " << (int)glyph->bitmap.rows - (int)glyph->bitmap_top << "\n   top bearing (bitmap_top): " << glyph->bitmap_top << "\n";
+	// Layout x of the caret before "character_index" on "line"... the 1st glyph at or after it is found by binary search.
+	float caret_x(const Message_Parent& message, const Query_Line& line, unsigned character_index) const
+	{
+		if (line.quad_count == 0)
+			return line.empty_x;
  
-			// Texture Coordinates Section (divide texture coordinate position values by texture size to get range [0, 1])
-			// ------------------------------------------------------------------------------------------------------------------------------------------
-			alphabet_character.texcoord_top_left.x = (float)tex_coord_left / (float)new_message.alphabet_texture_width;
-			alphabet_character.texcoord_top_left.y = (float)(tex_coord_top) / (float)new_message.alphabet_texture_height;
+		const float* start_x = nullptr;
+		const unsigned* quad_character = nullptr;
+		float offset_x = 0.0f;
+		query_arrays(message, start_x, quad_character, offset_x);
  
-			alphabet_character.texcoord_top_right.x = (float)(tex_coord_right) / (float)new_message.alphabet_texture_width;
-			alphabet_character.texcoord_top_right.y = (float)(tex_coord_top) / (float)new_message.alphabet_texture_height;
+		const unsigned* line_begin = quad_character + line.first_quad;
+		const unsigned* line_end = line_begin + line.quad_count;
+		unsigned quad = (unsigned)(std::lower_bound(line_begin, line_end, character_index) - quad_character);
  
-			alphabet_character.texcoord_bottom_left.x = (float)(tex_coord_left) / (float)new_message.alphabet_texture_width;
-			alphabet_character.texcoord_bottom_left.y = (float)(tex_coord_bottom) / (float)new_message.alphabet_texture_height;
+		if (quad < line.first_quad + line.quad_count)
+			return start_x[quad] + offset_x;
  
-			alphabet_character.texcoord_bottom_right.x = (float)(tex_coord_right) / (float)new_message.alphabet_texture_width;
-			alphabet_character.texcoord_bottom_right.y = (float)(tex_coord_bottom) / (float)new_message.alphabet_texture_height;
+		return glyph_end_x(message, quad - 1, start_x, quad_character) + offset_x; // After the line's last glyph.
+	}
  
-			new_message.alphabet_vec.push_back(alphabet_character); // Used in: process_text_compare()
+	Text_Rect line_rect(const Message_Parent& message, const Query_Line& line, float left_x, float right_x) const
+	{
+		float top_y = line.baseline_y + message.alphabet_metrics->ascender * message.glyph_pixel_scale;
+		float bottom_y = line.baseline_y + message.alphabet_metrics->descender * message.glyph_pixel_scale; // Descender is negative.
  
-			++character_count;
-			if (character_count == character_row_limit)
+		Text_Rect rect;
+		rect.x = left_x;
+		rect.y = -top_y;
+		rect.width = right_x - left_x;
+		rect.height = top_y - bottom_y;
+		return rect;
+	}
+ 
+	// Phases (1) & (2) of batch creation: new alphabets rasterised as jobs, then the layout across all cores as each alphabet becomes ready... "new_messages" is filled in "message_descs" order.
+	void lay_out_message_batch(const Message_Desc* message_descs, size_t count, std::vector<Message_Parent>& new_messages)
+	{
+		new_messages.reserve(count); // Reserved up front: jobs write into these while later ones are still being added.
+		messages.reserve(messages.size() + count);
+ 
+		// (1) Render thread: find each message's alphabet... every new alphabet (1 per font path & size in the batch) is rasterised as its own job, all in parallel.
+		// -----------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		struct Layout_Group // The messages sharing 1 alphabet source, laid out once its job (if any) has finished.
+		{
+			int alphabet_owner = -1; // The batch message whose job rasterises the alphabet (-1 = an existing alphabet)
+			Job_System::Job_Handle alphabet_job;
+			std::vector<unsigned> message_indices;
+			std::atomic<unsigned> next_index{ 0 };
+		};
+		std::deque<Layout_Group> groups(1); // Deque, so the groups (and their atomics) never move... groups[0] = messages using existing alphabets.
+ 
+		for (unsigned i = 0; i < count; ++i)
+		{
+			new_messages.emplace_back(&message_arena);
+			Message_Parent& new_message = new_messages[i];
+ 
+			new_message.font_size = message_descs[i].font_size;
+			new_message.font_path = message_descs[i].font_path;
+			new_message.fallback_font_paths = fallback_font_paths;
+			new_message.alphabet_characters = alphabet_codepoints;
+			new_message.glyph_pixel_scale = 1.0f / dpi_scale;
+			new_message.message_string.assign(message_descs[i].message.data(), message_descs[i].message.size());
+			new_message.dynamic_static = message_descs[i].dynamic_static;
+ 
+			int existing_alphabet = find_alphabet(messages, new_message.font_path, new_message.font_size);
+			if (existing_alphabet != -1)
 			{
-				character_count = 0;				
-				increment_y += new_message.tallest_font_height + (alphabet_padding * 2);
-				increment_x = alphabet_padding;
+				copy_alphabet(new_message, messages[existing_alphabet]);
+				groups[0].message_indices.push_back(i);
+				continue;
+			}
+			Layout_Group* group = nullptr;
+			for (Layout_Group& batch_group : groups)
+				if (batch_group.alphabet_owner != -1 && new_messages[batch_group.alphabet_owner].font_path == new_message.font_path && new_messages[batch_group.alphabet_owner].font_size == new_message.font_size)
+					group = &batch_group;
+ 
+			if (!group)
+			{
+				groups.emplace_back();
+				group = &groups.back();
+				group->alphabet_owner = (int)i;
+				group->alphabet_job = submit_alphabet_job(new_message);
 			}
+			group->message_indices.push_back(i);
 		}
-		glActiveTexture(GL_TEXTURE0);		
-	}	
  
-	void create_alphabet_image_quad(Message_Parent& new_message)
-	{	
-		float x = new_message.alphabet_start_x;
-		float y = new_message.alphabet_start_y;
+		// (2) Jobs: layout only (no renderer calls)... each group's messages are shared out between up to 1 job per worker, which start as soon as the group's alphabet is ready
+		// (so layout against 1 font overlaps rasterising the next). Each message's vectors act as that job's own output buffers.
+		// ---------------------------------------------------------------------------------------------------------------------------------------------------------------------------------
+		std::vector<Job_System::Job_Handle> layout_jobs;
+		for (Layout_Group& group : groups)
+		{
+			unsigned job_count = std::min(jobs().size() + 1, (unsigned)group.message_indices.size());
  
-		float width = new_message.alphabet_texture_width * scale_pixels_x_to_OpenGL;
-		float height = new_message.alphabet_texture_height * scale_pixels_y_to_OpenGL;
+			for (unsigned j = 0; j < job_count; ++j)
+			{
+				layout_jobs.push_back(jobs().submit([this, &group, &new_messages, message_descs]()
+					{
+						for (unsigned g = group.next_index++; g < group.message_indices.size(); g = group.next_index++)
+						{
+							unsigned i = group.message_indices[g];
+							if (group.alphabet_owner != -1 && group.alphabet_owner != (int)i)
+								copy_alphabet(new_messages[i], new_messages[group.alphabet_owner]);
  
-		float margin = 50 * scale_pixels_x_to_OpenGL; // Display each alphabet to the right of the previous one.
-		if (messages.size() > 0)
+							process_text_compare(new_messages[i], message_descs[i].text_start_x, message_descs[i].text_start_y);
+						}
+					}, { group.alphabet_job }));
+			}
+		}
+		jobs().wait(layout_jobs); // The render thread helps... then creates the new alphabets' textures.
+ 
+		for (Layout_Group& group : groups)
 		{
-			x = messages[messages.size() - 1].alphabet_start_x + (messages[messages.size() - 1].alphabet_texture_width * scale_pixels_x_to_OpenGL) + margin;
-			new_message.alphabet_start_x = x;
+			if (group.alphabet_owner == -1)
+				continue;
+ 
+			const Message_Parent& owner = new_messages[group.alphabet_owner];
+			upload_alphabet_job(new_messages[group.alphabet_owner]);
+ 
+			for (unsigned i : group.message_indices) // Their alphabets were copied (for layout) before the texture existed.
+			{
+				new_messages[i].alphabet_texture = owner.alphabet_texture;
+				new_messages[i].alphabet_texture_width = owner.alphabet_texture_width;
+				new_messages[i].alphabet_texture_height = owner.alphabet_texture_height;
+			}
 		}
-		// Triangle 1
-		// -------------
-		new_message.alphabet_quad.bottom_left_tr1.x = x;
-		new_message.alphabet_quad.bottom_left_tr1.y = y;
-		new_message.alphabet_quad.bottom_left_tr1.z = 0.0f;
-		new_message.alphabet_quad.bottom_left_tr1.w = 1.0f;
+	}
  
-		new_message.alphabet_quad.bottom_right_tr1.x = x + width;
-		new_message.alphabet_quad.bottom_right_tr1.y = y;
-		new_message.alphabet_quad.bottom_right_tr1.z = 1.0f;
-		new_message.alphabet_quad.bottom_right_tr1.w = 1.0f;
+	// Called with "measure_mutex" locked... a font with no alphabet yet is measured from private faces (its fallback chain, opened, read into the table, then closed)
+	const Measure_Font& find_measure_font(const std::string& font_path, int font_size)
+	{
+		for (const Measure_Font& font : measure_fonts)
+		{
+			if (font.font_size == font_size && font.font_path == font_path)
+				return font;
+		}
+		measure_fonts.emplace_back();
+		Measure_Font& font = measure_fonts.back();
+		font.font_path = font_path;
+		font.font_size = font_size;
  
-		new_message.alphabet_quad.top_left_tr1.x = x;
-		new_message.alphabet_quad.top_left_tr1.y = y + height;
-		new_message.alphabet_quad.top_left_tr1.z = 0.0f;
-		new_message.alphabet_quad.top_left_tr1.w = 0.0f;
+		Face_Chain chain;
+		chain.private_faces = true;
+		chain.key = font_path;
  
-		// Triangle 2
-		// -------------
-		new_message.alphabet_quad.top_left_tr2.x = x;
-		new_message.alphabet_quad.top_left_tr2.y = y + height;
-		new_message.alphabet_quad.top_left_tr2.z = 0.0f;
-		new_message.alphabet_quad.top_left_tr2.w = 0.0f;
+		std::vector<std::string> chain_paths(1, font_path);
+		chain_paths.insert(chain_paths.end(), measure_fallback_font_paths.begin(), measure_fallback_font_paths.end());
  
-		new_message.alphabet_quad.top_right_tr2.x = x + width;
-		new_message.alphabet_quad.top_right_tr2.y = y + height;
-		new_message.alphabet_quad.top_right_tr2.z = 1.0f;
-		new_message.alphabet_quad.top_right_tr2.w = 0.0f;
+		for (unsigned i = 0; i < chain_paths.size(); ++i)
+		{
+			FT_Face measure_face = nullptr;
+			FT_Error error_code{};
+			{
+				std::lock_guard<std::mutex> free_type_lock(free_type_mutex);
+				error_code = FT_New_Face(free_type, chain_paths[i].c_str(), 0, &measure_face);
+			}
+			if (error_code)
+			{
+				std::cout << "\n\n   Error code: " << error_code << " --- " << "measure_text(...) could not open font: " << chain_paths[i].c_str();
+				if (i == 0)
+					return font; // All zero.
+				continue;
+			}
+			FT_Set_Pixel_Sizes(measure_face, 0, font_size);
+			chain.faces.push_back(measure_face);
  
-		new_message.alphabet_quad.bottom_right_tr2.x = x + width;
-		new_message.alphabet_quad.bottom_right_tr2.y = y;
-		new_message.alphabet_quad.bottom_right_tr2.z = 1.0f;
-		new_message.alphabet_quad.bottom_right_tr2.w = 1.0f;
-	}	
+			if (i > 0)
+				chain.key += "|" + chain_paths[i]; // As in: set_font_parameters(...), so the resolved codepoints are shared with the alphabets.
+		}
  
-	void set_buffer_data_alphabet(Message_Parent& new_message)
+		int tallest_font_height = 0;
+		for (unsigned i = 0; i < alphabet_codepoints.size(); ++i) // Only the alphabet's characters, as layout skips the rest.
+		{
+			Glyph_Source source = resolve_codepoint(chain, alphabet_codepoints[i]);
+			FT_Face source_face = chain.faces[source.face_index];
+ 
+			if (FT_Load_Glyph(source_face, source.glyph_index, FT_LOAD_DEFAULT) == 0) // Hinted (not rendered), so the metrics are whole pixels, as the rendered bitmaps are.
+			{
+				set_measure_advance(font, alphabet_codepoints[i], (int)(source_face->glyph->advance.x / 64)); // Truncated, as with the alphabet's.
+				tallest_font_height = std::max(tallest_font_height, (int)(source_face->glyph->metrics.height / 64));
+			}
+		}
+		std::sort(font.extended_advance.begin(), font.extended_advance.end());
+		font.ascender = (int)(chain.faces[0]->size->metrics.ascender >> 6);
+		font.descender = (int)(chain.faces[0]->size->metrics.descender >> 6);
+		font.line_height = tallest_font_height + alphabet_padding; // As in: reflow_paragraph(...)
+ 
+		close_face_chain(chain);
+		return font;
+	}
+ 
+	void set_measure_advance(Measure_Font& font, char32_t codepoint, int advance)
 	{
-		glGenVertexArrays(1, &new_message.VAO_alphabet);
-		glGenBuffers(1, &new_message.VBO_alphabet);
+		if (codepoint < 128)
+			font.advance[codepoint] = advance;
+		else
+			font.extended_advance.push_back(std::make_pair(codepoint, advance));
+	}
  
-		glBindVertexArray(new_message.VAO_alphabet);
-		glBindBuffer(GL_ARRAY_BUFFER, new_message.VBO_alphabet);
-		
-		glBufferData(GL_ARRAY_BUFFER, 6 * 4 * sizeof(float), &new_message.alphabet_quad, GL_STATIC_DRAW);
+	// Replaces (or adds) the font's measurement table with the values layout will actually use... called once an alphabet's metrics exist.
+	void register_measure_alphabet(const Message_Parent& new_message)
+	{
+		std::lock_guard<std::mutex> measure_lock(measure_mutex);
+ 
+		Measure_Font* font = nullptr;
+		for (Measure_Font& existing : measure_fonts)
+		{
+			if (existing.font_size == new_message.font_size && existing.font_path == new_message.font_path)
+				font = &existing;
+		}
+		if (font && font->from_alphabet && font->alphabet_scale == new_message.glyph_pixel_scale)
+			return;
+ 
+		if (!font)
+		{
+			measure_fonts.emplace_back();
+			font = &measure_fonts.back();
+			font->font_path = new_message.font_path;
+			font->font_size = new_message.font_size;
+		}
+		const Alphabet_Metrics& metrics = *new_message.alphabet_metrics;
+ 
+		std::fill(std::begin(font->advance), std::end(font->advance), 0);
+		font->extended_advance.clear();
+ 
+		for (unsigned i = 0; i < metrics.size(); ++i)
+			set_measure_advance(*font, metrics.codepoint[i], (int)std::lround(metrics.glyph_advance_x[i])); // Layout pixels (the advances are already scaled)
  
-		glEnableVertexAttribArray(0);
-		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, (void*)0);
+		std::sort(font->extended_advance.begin(), font->extended_advance.end());
  
-		glBindVertexArray(0);
+		font->ascender = (int)std::lround(metrics.ascender * new_message.glyph_pixel_scale);
+		font->descender = (int)std::lround(metrics.descender * new_message.glyph_pixel_scale);
+		font->line_height = (int)std::lround((new_message.tallest_font_height + alphabet_padding) * new_message.glyph_pixel_scale); // As in: reflow_paragraph(...)
+		font->from_alphabet = true;
+		font->alphabet_scale = new_message.glyph_pixel_scale;
+ 
+		for (Measure_Memo& memo : measure_memo) // Memoised extents may have come from the glyph metrics.
+			memo.font = nullptr;
 	}
  
-	void process_text_compare(Message_Parent& new_message, int text_start_x, int text_start_y)
+	// Frees the slots of chunks that left the view, then lays out (into a free slot) each visible chunk not already resident.
+	void update_document_chunks(Document& document)
 	{
-		float advance_to_next_character = 0.0f;
+		float line_height = (document.layout.tallest_font_height + alphabet_padding) * document.layout.glyph_pixel_scale;
+		unsigned line_count = (unsigned)document.line_starts.size();
+		unsigned chunk_count = (line_count + document_chunk_lines - 1) / document_chunk_lines;
  
-		// "relative_distance" and "tallest_character" are fixed values, calculated per message (used here to align the text's highest pixel to the display window's top row of pixels)
-		float tallest_character = new_message.tallest_font_height * scale_pixels_y_to_OpenGL;
-		float relative_distance = new_message.relative_distance * scale_pixels_y_to_OpenGL;
+		unsigned first_line = (unsigned)(document.scroll_y / line_height);
+		unsigned last_line = std::min(line_count - 1, (unsigned)((document.scroll_y + document.view_height) / line_height) + 1);
  
-		for (unsigned i = 0; i < new_message.message_string.size(); ++i)
+		int first_chunk = (int)(first_line / document_chunk_lines);
+		int end_chunk = (int)std::min(chunk_count, last_line / document_chunk_lines + 1);
+ 
+		for (Document_Chunk& chunk : document.chunks)
+			if (chunk.chunk_index < first_chunk || chunk.chunk_index >= end_chunk)
+				chunk.chunk_index = -1; // Its buffer is kept, for the next chunk to scroll in.
+ 
+		for (int c = first_chunk; c < end_chunk; ++c)
 		{
-			for (unsigned i2 = 0; i2 < new_message.alphabet_vec.size(); ++i2)
+			Document_Chunk* free_slot = nullptr;
+			bool resident = false;
+ 
+			for (Document_Chunk& chunk : document.chunks)
 			{
-				if (new_message.message_string.c_str()[i] == new_message.alphabet_vec[i2].character)
-				{
-					if (advance_to_next_character == 0) // Start X, Y positions need setting here, but only for the 1st character, i.e. when: advance_to_next_character = 0
-					{
-						// Enable these two lines for 2D window-positioned text
-						// -----------------------------------------------------------------------
-						new_message.text_start_x = -1.0f - new_message.alphabet_vec[i2].left_bearing + (text_start_x - alphabet_padding) * scale_pixels_x_to_OpenGL;
-						new_message.text_start_y = 1.0f + relative_distance - tallest_character - (text_start_y + alphabet_padding) * scale_pixels_y_to_OpenGL;
- 
-						// Enable these two lines instead for 3D animated text
-						// --------------------------------------------------------------------
-						// new_message.text_start_x = -1.35f;
-						// new_message.text_start_y = 0.0f;
-					}
-					process_text_index(new_message, i2, advance_to_next_character);					
-					advance_to_next_character += new_message.alphabet_vec[i2].glyph_advance_x;
+				resident = resident || chunk.chunk_index == c;
+				if (chunk.chunk_index == -1 && !free_slot)
+					free_slot = &chunk;
+			}
+			if (resident)
+				continue;
  
-					break; // Stop checking the alphabet if the character is found.
-				}
+			if (!free_slot)
+			{
+				document.chunks.emplace_back();
+				free_slot = &document.chunks.back();
 			}
-		}		
+			lay_out_document_chunk(document, *free_slot, c);
+		}
 	}
  
-	void initialise_buffer_data_message(Message_Parent& new_message)
+	void lay_out_document_chunk(Document& document, Document_Chunk& chunk, int chunk_index)
 	{
-		glGenVertexArrays(1, &new_message.VAO_message);
-		glGenBuffers(1, &new_message.VBO_message);
+		Message_Parent& layout = document.layout;
+		const Alphabet_Metrics& metrics = *layout.alphabet_metrics;
  
-		glBindVertexArray(new_message.VAO_message);
-		glBindBuffer(GL_ARRAY_BUFFER, new_message.VBO_message);
+		layout.characters_quads.clear();
+		layout.start_x_current.clear();
+		layout.quad_character.clear();
  
-		new_message.allocated_memory_bytes = new_message.characters_quads.size() * 6 * 4 * sizeof(float);
+		float line_height = (layout.tallest_font_height + alphabet_padding) * layout.glyph_pixel_scale; // As in: reflow_paragraph(...)
+		float document_x = document.view_x - alphabet_padding * layout.glyph_pixel_scale;
+		float document_y = -document.view_y + (layout.relative_distance - layout.tallest_font_height - alphabet_padding) * layout.glyph_pixel_scale;
+ 
+		static thread_local std::vector<unsigned> glyph_indices;
+ 
+		unsigned first_line = chunk_index * document_chunk_lines;
+		unsigned end_line = std::min((unsigned)document.line_starts.size(), first_line + document_chunk_lines);
+ 
+		for (unsigned line = first_line; line < end_line; ++line)
+		{
+			size_t line_begin = document.line_starts[line];
+			size_t line_end = (line + 1 < document.line_starts.size()) ? document.line_starts[line + 1] - 1 : document.text.size(); // Excluding the '\n'
+ 
+			glyph_indices.clear();
+			collect_glyphs(metrics, document.text.data(), line_begin, line_end, glyph_indices, layout.quad_character);
+ 
+			unsigned count = std::min((unsigned)glyph_indices.size(), document.max_line_glyphs); // The rest would be clipped anyway.
+			layout.quad_character.resize(layout.characters_quads.size() + count);
+ 
+			if (count > 0)
+			{
+				unsigned first_quad = (unsigned)layout.characters_quads.size();
+				layout.characters_quads.resize(first_quad + count);
+				layout.start_x_current.resize(first_quad + count);
+ 
+				layout.text_start_x = document_x;
+				layout.text_start_y = document_y - line * line_height;
+				process_text_quads(layout, &glyph_indices[0], count, first_quad);
+			}
+		}
+ 
+		if (chunk.VAO_chunk == 0)
+			renderer.create_quad_buffer(chunk.VAO_chunk, chunk.VBO_chunk, 0, nullptr, Text_Buffer_Usage::dynamic_draw);
+ 
+		size_t required_bytes = layout.characters_quads.size() * sizeof(Message_Characters);
+		if (required_bytes > chunk.allocated_memory_bytes)
+		{
+			chunk.allocated_memory_bytes = required_bytes + required_bytes / 2; // Headroom, so recycling the slot for a slightly busier chunk doesn't reallocate.
+			renderer.allocate_quad_buffer(chunk.VBO_chunk, chunk.allocated_memory_bytes, Text_Buffer_Usage::dynamic_draw);
+		}
+		if (required_bytes > 0)
+			renderer.update_quad_buffer(chunk.VBO_chunk, 0, required_bytes, layout.characters_quads.data());
+ 
+		chunk.chunk_index = chunk_index;
+		chunk.quad_count = (unsigned)layout.characters_quads.size();
+	}
+ 
+	unsigned pack_grid_cell(const Terminal_Grid& grid, char32_t codepoint, glm::vec3 colour) const
+	{
+		int glyph = (codepoint == 0) ? -1 : grid.layout.alphabet_metrics->glyph_index(codepoint);
+		if (glyph == -1)
+			return 0;
+ 
+		unsigned red = (unsigned)glm::clamp(colour.r / 255.0f * 31.0f + 0.5f, 0.0f, 31.0f); // RGB565
+		unsigned green = (unsigned)glm::clamp(colour.g / 255.0f * 63.0f + 0.5f, 0.0f, 63.0f);
+		unsigned blue = (unsigned)glm::clamp(colour.b / 255.0f * 31.0f + 0.5f, 0.0f, 31.0f);
+ 
+		return (unsigned)(glyph + 1) | (blue << 16) | (green << 21) | (red << 27);
+	}
+ 
+	// Packs each quad's span (if any) into 1 unsigned: RGB in bits 0-23, style in 24-27, shadow in bit 28, and bit 31 = "has a span"...
+	// ...messages without spans leave vertex attribute 1 disabled, so the shader reads its default of 0 (i.e. the "font_colour" uniform)
+	void upload_span_attributes(Message_Parent& message)
+	{
+		static thread_local std::vector<unsigned> vertex_attributes;
+		vertex_attributes.assign(message.characters_quads.size() * 6, 0);
+ 
+		for (const Text_Span& span : message.spans)
+		{
+			unsigned packed = (unsigned)glm::clamp(span.colour.r + 0.5f, 0.0f, 255.0f) | ((unsigned)glm::clamp(span.colour.g + 0.5f, 0.0f, 255.0f) << 8) | ((unsigned)glm::clamp(span.colour.b + 0.5f, 0.0f, 255.0f) << 16)
+				| ((span.style & 0xFu) << 24) | ((span.shadow ? 1u : 0u) << 28) | 0x80000000u;
  
-		if (new_message.dynamic_static)
-			glBufferData(GL_ARRAY_BUFFER, new_message.allocated_memory_bytes, NULL, GL_DYNAMIC_DRAW);
+			// "quad_character" ascends through the message, so each span's quads are found by binary search.
+			unsigned first_quad = (unsigned)(std::lower_bound(message.quad_character.begin(), message.quad_character.end(), span.first_character) - message.quad_character.begin());
+			unsigned end_quad = (unsigned)(std::lower_bound(message.quad_character.begin(), message.quad_character.end(), span.end_character) - message.quad_character.begin());
+ 
+			for (unsigned i = first_quad * 6; i < end_quad * 6 && i < vertex_attributes.size(); ++i)
+				vertex_attributes[i] = packed;
+		}
+		renderer.set_vertex_attributes(message.VAO_message, message.VBO_attributes, vertex_attributes.data(), message.spans.empty() ? 0 : vertex_attributes.size());
+	}
+ 
+	// Where a span edge lands after the characters [edit_start, edit_start + erase_count) were replaced by "insert_count" new ones.
+	unsigned shift_span_edge(unsigned edge, unsigned edit_start, unsigned erase_count, unsigned insert_count) const
+	{
+		if (edge <= edit_start)
+			return edge;
+		if (edge >= edit_start + erase_count)
+			return edge - erase_count + insert_count;
+ 
+		return edit_start + insert_count; // Inside the erased characters.
+	}
+ 
+	void draw_message(const Message_Parent& message) // Between renderer.begin_quads() & end_quads()
+	{
+		unsigned quad_count = (unsigned)message.characters_quads.size(); // Cast (unsigned) silences the compiler warning (unsigned 32 bit is still over 4 billion)
+		glm::vec2 offset(0.0f); // Unshared messages are laid out at their final position.
+ 
+		if (message.glyph_run)
+		{
+			quad_count = message.glyph_run->quad_count;
+			offset = message.run_offset;
+		}
+		renderer.draw_quads(message.VAO_message, message.alphabet_texture, message.buffer_first_quad, quad_count, offset);
+	}
+ 
+	size_t glyph_run_key(const std::string& message, const std::string& font_path, int font_size) const
+	{
+		size_t key = std::hash<std::string>()(message);
+		key ^= std::hash<std::string>()(font_path) + 0x9e3779b9 + (key << 6) + (key >> 2); // boost::hash_combine(...) mixing.
+		key ^= std::hash<int>()(font_size) + 0x9e3779b9 + (key << 6) + (key >> 2);
+		return key;
+	}
+ 
+	// Points a static message at the cached glyph run for its string, font & size... laying the run out (once, at pixel 0, 0) on a cache miss.
+	void share_glyph_run(Message_Parent& new_message, const std::string& message, int text_start_x, int text_start_y)
+	{
+		size_t key = glyph_run_key(message, new_message.font_path, new_message.font_size);
+		auto found = glyph_run_cache.find(key);
+ 
+		std::shared_ptr<const Glyph_Run> run;
+		if (found != glyph_run_cache.end() && found->second->message_string == message && found->second->alphabet_metrics == new_message.alphabet_metrics)
+			run = found->second;
 		else
-			glBufferData(GL_ARRAY_BUFFER, new_message.allocated_memory_bytes, NULL, GL_STATIC_DRAW);
+		{
+			new_message.message_string.assign(message.data(), message.size());
+			process_text_compare(new_message, 0, 0); // Layout is a pure translation of the start position, so (0, 0) suits every copy.
+ 
+			initialise_buffer_data_message(new_message);
+			update_buffer_data_message(new_message, 0);
+ 
+			std::shared_ptr<Glyph_Run> new_run = std::make_shared<Glyph_Run>();
+			new_run->VAO_run = new_message.VAO_message;
+			new_run->VBO_run = new_message.VBO_message;
+			new_run->quad_count = (unsigned)new_message.characters_quads.size();
+			new_run->message_string = message;
+			new_run->alphabet_metrics = new_message.alphabet_metrics;
+			new_run->text_start_x = new_message.text_start_x;
+			new_run->text_start_y = new_message.text_start_y;
+			new_run->start_x_current.assign(new_message.start_x_current.begin(), new_message.start_x_current.end());
+			new_run->quad_character.assign(new_message.quad_character.begin(), new_message.quad_character.end());
+			run = new_run;
+ 
+			if (found == glyph_run_cache.end()) // A colliding key keeps the first run (this message simply isn't shared)
+				glyph_run_cache.emplace(key, run);
+ 
+			std::pmr::vector<Message_Characters>(new_message.characters_quads.get_allocator()).swap(new_message.characters_quads); // The GPU copy is all that's drawn.
+			std::pmr::vector<float>(new_message.start_x_current.get_allocator()).swap(new_message.start_x_current);
+			std::pmr::vector<unsigned>(new_message.quad_character.get_allocator()).swap(new_message.quad_character);
+		}
+		attach_glyph_run(new_message, run, text_start_x, text_start_y);
+	}
  
-		glEnableVertexAttribArray(0);
-		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, (void*)0);
+	void attach_glyph_run(Message_Parent& new_message, const std::shared_ptr<const Glyph_Run>& run, int text_start_x, int text_start_y)
+	{
+		new_message.message_string.assign(run->message_string.data(), run->message_string.size());
+		new_message.VAO_message = run->VAO_run;
+		new_message.VBO_message = run->VBO_run;
+		new_message.allocated_memory_bytes = 0; // The buffer belongs to the run.
+		new_message.requested_start_x = text_start_x;
+		new_message.requested_start_y = text_start_y;
+		new_message.run_offset = glm::vec2((float)text_start_x, (float)-text_start_y);
+		new_message.text_start_x = run->text_start_x + new_message.run_offset.x;
+		new_message.text_start_y = run->text_start_y + new_message.run_offset.y;
+		new_message.glyph_run = run;
+	}
  
-		glBindVertexArray(0);
+	void initialise_buffer_data_message(Message_Parent& new_message)
+	{
+		new_message.allocated_memory_bytes = new_message.characters_quads.size() * 6 * 4 * sizeof(float);
+		renderer.create_quad_buffer(new_message.VAO_message, new_message.VBO_message, new_message.allocated_memory_bytes, nullptr, new_message.dynamic_static ? Text_Buffer_Usage::dynamic_draw : Text_Buffer_Usage::static_draw);
 	}
+ 
+	std::unique_ptr<Job_System> job_system; // Created on first use, see: jobs()... declared last, so it's destroyed (finishing any queued jobs) before the members those jobs use.
 };
\ No newline at end of file
@@ -0,0 +1,211 @@
+#pragma once // The GPU side of "text_fonts_glyphs.h"... Text makes no graphics API calls itself, only calls through a Text_Renderer, so its fonts, atlases & layout run without a context.
+ 
+// Handles are renderer-issued ids (0 = none). A "quad buffer" is a vertex array & buffer of Text::Message_Characters, i.e. 6 vertices per glyph quad, each a vec4 (x, y, u, v) in attribute 0
+// Atlas textures are single channel, 8 bits per texel... the text shaders sample them from unit 31 ("text_Texture"). All calls come from the thread that owns the Text object.
+enum class Text_Buffer_Usage { static_draw, dynamic_draw, stream_draw };
+ 
+class Text_Renderer
+{
+public:
+	virtual ~Text_Renderer() = default;
+ 
+	// Quad buffers
+	// ------------------
+	virtual void create_quad_buffer(unsigned& vertex_array, unsigned& buffer, size_t bytes, const void* data, Text_Buffer_Usage usage) = 0; // "data" may be null (allocate only)
+	virtual void allocate_quad_buffer(unsigned buffer, size_t bytes, Text_Buffer_Usage usage) = 0; // New storage, contents undefined (orphans a streaming buffer's previous frame)
+	virtual void update_quad_buffer(unsigned buffer, size_t offset_bytes, size_t bytes, const void* data) = 0;
+	virtual void* map_quad_buffer(unsigned buffer, size_t bytes) = 0; // Write-only, the first "bytes" are invalidated... null on failure, otherwise follow with: unmap_quad_buffer(...)
+	virtual void unmap_quad_buffer(unsigned buffer) = 0;
+	virtual void delete_quad_buffer(unsigned& vertex_array, unsigned& buffer) = 0; // Both reset to 0.
+ 
+	// 1 packed unsigned per vertex (attribute 1) alongside a quad buffer... "count" 0 detaches it (the buffer is kept for the next call)
+	virtual void set_vertex_attributes(unsigned vertex_array, unsigned& attribute_buffer, const unsigned* attributes, size_t count) = 0;
+	virtual void delete_vertex_attributes(unsigned& attribute_buffer) = 0;
+ 
+	// Atlas textures
+	// ------------------
+	virtual void create_atlas_texture(unsigned& texture) = 0; // Nearest filtering, clamped... no storage until uploaded.
+	virtual void upload_atlas_pixels(unsigned texture, int width, int height, const unsigned char* pixels) = 0; // (Re)allocates the whole image... null "pixels" = allocate only.
+	virtual void upload_atlas_rows(unsigned texture, unsigned& staging_buffer, int width, int first_row, int row_count, const unsigned char* pixels) = 0; // Streams rows in through "staging_buffer" (created on first use)
+	virtual void delete_staging_buffer(unsigned& staging_buffer) = 0;
+	virtual void delete_texture(unsigned& texture) = 0;
+ 
+	// Terminal grids... integer textures, read (unfiltered) by the grid shader.
+	virtual void create_cell_texture(unsigned& texture, unsigned columns, unsigned rows, const unsigned* cells) = 0; // 1 unsigned per cell, row 0 at the top.
+	virtual void update_cell_texture(unsigned texture, unsigned column, unsigned row, unsigned count, const unsigned* cells) = 0; // "count" cells along 1 row.
+	virtual void create_glyph_table_texture(unsigned& texture, unsigned glyph_count, const short* table) = 0; // 2 rows of "glyph_count" 4 x 16-bit texels.
+ 
+	// Drawing
+	// ------------------
+	virtual void set_projection(unsigned program, const glm::mat4& projection) = 0;
+ 
+	// Quads are drawn (depth testing off) with whichever text program is in use, each range moved by "offset" (layout pixels) via its "message_offset" uniform.
+	virtual void begin_quads() = 0;
+	virtual void draw_quads(unsigned vertex_array, unsigned atlas_texture, unsigned first_quad, unsigned quad_count, glm::vec2 offset) = 0;
+	virtual void end_quads() = 0;
+ 
+	virtual void begin_clip(int left, int top, int width, int height) = 0; // Between begin_quads() & end_quads()... framebuffer pixels, from the top-left.
+	virtual void end_clip() = 0;
+ 
+	virtual void begin_grids(unsigned grid_program) = 0; // Restores the program in use in: end_grids()
+	virtual void draw_grid(unsigned vertex_array, unsigned atlas_texture, unsigned cell_texture, unsigned glyph_table_texture, int cell_width, int cell_height) = 0;
+	virtual void end_grids() = 0;
+};
+ 
+// No GPU at all: buffers & textures are plain memory, so the text core can be run, checked and timed without a window (e.g. in tools, on a worker thread, or in benchmarks)
+// Every buffer & atlas keeps its latest contents... draw calls are only counted.
+class Text_Renderer_Headless : public Text_Renderer
+{
+public:
+	unsigned draw_calls = 0;
+	unsigned quads_drawn = 0;
+ 
+	const std::vector<unsigned char>& buffer_data(unsigned buffer) // The vertex stream (or attributes) last written to "buffer"
+	{
+		return buffers[buffer];
+	}
+	const std::vector<unsigned char>& texture_pixels(unsigned texture) // Atlases & cell textures.
+	{
+		return textures[texture];
+	}
+ 
+	void create_quad_buffer(unsigned& vertex_array, unsigned& buffer, size_t bytes, const void* data, Text_Buffer_Usage usage) override
+	{
+		vertex_array = next_handle++;
+		buffer = next_handle++;
+		allocate_quad_buffer(buffer, bytes, usage);
+ 
+		if (data)
+			update_quad_buffer(buffer, 0, bytes, data);
+	}
+	void allocate_quad_buffer(unsigned buffer, size_t bytes, Text_Buffer_Usage) override
+	{
+		buffers[buffer].assign(bytes, 0);
+	}
+	void update_quad_buffer(unsigned buffer, size_t offset_bytes, size_t bytes, const void* data) override
+	{
+		std::vector<unsigned char>& storage = buffers[buffer];
+		if (offset_bytes + bytes > storage.size())
+		{
+			std::cout << "\n   Warning: Text_Renderer_Headless::update_quad_buffer(...) --- write past the end of buffer: " << buffer;
+			return;
+		}
+		if (bytes > 0)
+			memcpy(storage.data() + offset_bytes, data, bytes);
+	}
+	void* map_quad_buffer(unsigned buffer, size_t bytes) override
+	{
+		std::vector<unsigned char>& storage = buffers[buffer];
+		return (bytes <= storage.size()) ? storage.data() : nullptr;
+	}
+	void unmap_quad_buffer(unsigned) override
+	{
+	}
+	void delete_quad_buffer(unsigned& vertex_array, unsigned& buffer) override
+	{
+		buffers.erase(buffer);
+		vertex_array = 0;
+		buffer = 0;
+	}
+ 
+	void set_vertex_attributes(unsigned, unsigned& attribute_buffer, const unsigned* attributes, size_t count) override
+	{
+		if (attribute_buffer == 0)
+			attribute_buffer = next_handle++;
+ 
+		std::vector<unsigned char>& storage = buffers[attribute_buffer];
+		storage.assign((const unsigned char*)attributes, (const unsigned char*)(attributes + count));
+	}
+	void delete_vertex_attributes(unsigned& attribute_buffer) override
+	{
+		buffers.erase(attribute_buffer);
+		attribute_buffer = 0;
+	}
+ 
+	void create_atlas_texture(unsigned& texture) override
+	{
+		texture = next_handle++;
+		textures[texture].clear();
+	}
+	void upload_atlas_pixels(unsigned texture, int width, int height, const unsigned char* pixels) override
+	{
+		std::vector<unsigned char>& storage = textures[texture];
+		storage.assign((size_t)width * height, 0);
+ 
+		if (pixels)
+			memcpy(storage.data(), pixels, storage.size());
+	}
+	void upload_atlas_rows(unsigned texture, unsigned&, int width, int first_row, int row_count, const unsigned char* pixels) override
+	{
+		std::vector<unsigned char>& storage = textures[texture];
+		size_t offset_bytes = (size_t)first_row * width;
+		size_t bytes = (size_t)row_count * width;
+ 
+		if (offset_bytes + bytes <= storage.size())
+			memcpy(storage.data() + offset_bytes, pixels, bytes);
+	}
+	void delete_staging_buffer(unsigned& staging_buffer) override
+	{
+		staging_buffer = 0;
+	}
+	void delete_texture(unsigned& texture) override
+	{
+		textures.erase(texture);
+		texture = 0;
+	}
+ 
+	void create_cell_texture(unsigned& texture, unsigned columns, unsigned rows, const unsigned* cells) override
+	{
+		texture = next_handle++;
+		textures[texture].assign((const unsigned char*)cells, (const unsigned char*)(cells + columns * rows));
+		cell_texture_columns[texture] = columns;
+	}
+	void update_cell_texture(unsigned texture, unsigned column, unsigned row, unsigned count, const unsigned* cells) override
+	{
+		size_t first_cell = (size_t)row * cell_texture_columns[texture] + column;
+		memcpy(textures[texture].data() + first_cell * sizeof(unsigned), cells, count * sizeof(unsigned));
+	}
+	void create_glyph_table_texture(unsigned& texture, unsigned glyph_count, const short* table) override
+	{
+		texture = next_handle++;
+		textures[texture].assign((const unsigned char*)table, (const unsigned char*)(table + glyph_count * 4 * 2));
+	}
+ 
+	void set_projection(unsigned, const glm::mat4&) override
+	{
+	}
+	void begin_quads() override
+	{
+	}
+	void draw_quads(unsigned, unsigned, unsigned, unsigned quad_count, glm::vec2) override
+	{
+		++draw_calls;
+		quads_drawn += quad_count;
+	}
+	void end_quads() override
+	{
+	}
+	void begin_clip(int, int, int, int) override
+	{
+	}
+	void end_clip() override
+	{
+	}
+	void begin_grids(unsigned) override
+	{
+	}
+	void draw_grid(unsigned, unsigned, unsigned, unsigned, int, int) override
+	{
+		++draw_calls;
+		++quads_drawn;
+	}
+	void end_grids() override
+	{
+	}
+ 
+private:
+	unsigned next_handle = 1;
+	std::unordered_map<unsigned, std::vector<unsigned char>> buffers; // Vertex arrays have no storage (their handles are only issued)
+	std::unordered_map<unsigned, std::vector<unsigned char>> textures;
+	std::unordered_map<unsigned, unsigned> cell_texture_columns;
+};
@@ -0,0 +1,284 @@
+#pragma once // OpenGL 4.2 backend for "text_fonts_glyphs.h"... the only place the text code makes GL calls. Create it once the context is current, and use it on that context's thread.
+ 
+// Texture units: 31 = the atlas (shader_glsl.frag's "text_Texture" & terminal_grid.frag's "alphabet_texture"), 30 = a grid's cells, 29 = a grid's glyph table.
+class Text_Renderer_GL : public Text_Renderer
+{
+public:
+	void create_quad_buffer(unsigned& vertex_array, unsigned& buffer, size_t bytes, const void* data, Text_Buffer_Usage usage) override
+	{
+		glGenVertexArrays(1, &vertex_array);
+		glGenBuffers(1, &buffer);
+ 
+		glBindVertexArray(vertex_array);
+		glBindBuffer(GL_ARRAY_BUFFER, buffer);
+ 
+		glBufferData(GL_ARRAY_BUFFER, bytes, data, gl_usage(usage));
+ 
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, (void*)0);
+		glBindVertexArray(0);
+	}
+	void allocate_quad_buffer(unsigned buffer, size_t bytes, Text_Buffer_Usage usage) override
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, buffer);
+		glBufferData(GL_ARRAY_BUFFER, bytes, NULL, gl_usage(usage)); // Orphans the old storage... the driver hands back fresh memory rather than waiting on draws still using it.
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+	void update_quad_buffer(unsigned buffer, size_t offset_bytes, size_t bytes, const void* data) override
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, buffer);
+		glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)offset_bytes, (GLsizeiptr)bytes, data);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+	void* map_quad_buffer(unsigned buffer, size_t bytes) override
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, buffer);
+		return glMapBufferRange(GL_ARRAY_BUFFER, 0, (GLsizeiptr)bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	}
+	void unmap_quad_buffer(unsigned buffer) override
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, buffer);
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+	void delete_quad_buffer(unsigned& vertex_array, unsigned& buffer) override
+	{
+		glDeleteVertexArrays(1, &vertex_array);
+		glDeleteBuffers(1, &buffer);
+		vertex_array = 0;
+		buffer = 0;
+	}
+ 
+	void set_vertex_attributes(unsigned vertex_array, unsigned& attribute_buffer, const unsigned* attributes, size_t count) override
+	{
+		glBindVertexArray(vertex_array);
+ 
+		if (attribute_buffer == 0)
+			glGenBuffers(1, &attribute_buffer);
+ 
+		glBindBuffer(GL_ARRAY_BUFFER, attribute_buffer);
+		glBufferData(GL_ARRAY_BUFFER, count * sizeof(GLuint), count ? attributes : NULL, GL_DYNAMIC_DRAW);
+ 
+		if (count == 0)
+			glDisableVertexAttribArray(1);
+		else
+		{
+			glEnableVertexAttribArray(1);
+			glVertexAttribIPointer(1, 1, GL_UNSIGNED_INT, 0, (void*)0); // Integer attribute (not normalised to float)
+		}
+		glBindVertexArray(0);
+	}
+	void delete_vertex_attributes(unsigned& attribute_buffer) override
+	{
+		glDeleteBuffers(1, &attribute_buffer);
+		attribute_buffer = 0;
+	}
+ 
+	void create_atlas_texture(unsigned& texture) override
+	{
+		glGenTextures(1, &texture);
+		glActiveTexture(GL_TEXTURE31);
+		glBindTexture(GL_TEXTURE_2D, texture);
+ 
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+ 
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST); // GL_NEAREST... GL_LINEAR
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+ 
+		glActiveTexture(GL_TEXTURE0);
+	}
+	void upload_atlas_pixels(unsigned texture, int width, int height, const unsigned char* pixels) override
+	{
+		glActiveTexture(GL_TEXTURE31);
+		glBindTexture(GL_TEXTURE_2D, texture);
+ 
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+ 
+		// GL_RED = 8 bits = 1 byte per texel (the only channel the text shaders sample)
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, pixels);
+		glActiveTexture(GL_TEXTURE0);
+	}
+	void upload_atlas_rows(unsigned texture, unsigned& staging_buffer, int width, int first_row, int row_count, const unsigned char* pixels) override
+	{
+		if (staging_buffer == 0)
+			glGenBuffers(1, &staging_buffer);
+ 
+		size_t slice_bytes = (size_t)width * row_count;
+ 
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging_buffer);
+		glBufferData(GL_PIXEL_UNPACK_BUFFER, slice_bytes, NULL, GL_STREAM_DRAW); // Orphan the previous slice, so mapping never waits on the GPU.
+ 
+		void* mapped_slice = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, slice_bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+		if (mapped_slice)
+		{
+			memcpy(mapped_slice, pixels, slice_bytes);
+			glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+ 
+			glActiveTexture(GL_TEXTURE31);
+			glBindTexture(GL_TEXTURE_2D, texture);
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+ 
+			// The pixel data pointer is an offset into the bound PBO, so the copy into the texture is done by the driver/GPU (DMA) rather than the CPU.
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, first_row, width, row_count, GL_RED, GL_UNSIGNED_BYTE, (void*)0);
+			glActiveTexture(GL_TEXTURE0);
+		}
+		else
+			std::cout << "\n   Warning: Text_Renderer_GL::upload_atlas_rows(...) --- glMapBufferRange(...) failed, so rows " << first_row << " to " << first_row + row_count - 1 << " were skipped.";
+ 
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+	void delete_staging_buffer(unsigned& staging_buffer) override
+	{
+		glDeleteBuffers(1, &staging_buffer);
+		staging_buffer = 0;
+	}
+	void delete_texture(unsigned& texture) override
+	{
+		glDeleteTextures(1, &texture);
+		texture = 0;
+	}
+ 
+	void create_cell_texture(unsigned& texture, unsigned columns, unsigned rows, const unsigned* cells) override
+	{
+		glGenTextures(1, &texture);
+		glActiveTexture(GL_TEXTURE30);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST); // Integer textures are incomplete with linear filtering or mipmaps.
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, columns, rows, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, cells);
+		glActiveTexture(GL_TEXTURE0);
+	}
+	void update_cell_texture(unsigned texture, unsigned column, unsigned row, unsigned count, const unsigned* cells) override
+	{
+		glActiveTexture(GL_TEXTURE30);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, column, row, count, 1, GL_RED_INTEGER, GL_UNSIGNED_INT, cells);
+		glActiveTexture(GL_TEXTURE0);
+	}
+	void create_glyph_table_texture(unsigned& texture, unsigned glyph_count, const short* table) override
+	{
+		glGenTextures(1, &texture);
+		glActiveTexture(GL_TEXTURE29);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16I, glyph_count, 2, 0, GL_RGBA_INTEGER, GL_SHORT, table);
+		glActiveTexture(GL_TEXTURE0);
+	}
+ 
+	void set_projection(unsigned program, const glm::mat4& projection) override
+	{
+		glProgramUniformMatrix4fv(program, glGetUniformLocation(program, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+	}
+ 
+	void begin_quads() override
+	{
+		GLint program = 0;
+		glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+		offset_location = program ? glGetUniformLocation(program, "message_offset") : -1; // -1 = the uniform is absent, which glUniform*() ignores.
+		current_offset = glm::vec2(0.0f);
+ 
+		glVertexAttribI4ui(1, 0, 0, 0, 0); // Read by messages without spans (attribute 1 disabled)... the default current value is float (0, 0, 0, 1), undefined through a "uint" input.
+ 
+		glDisable(GL_DEPTH_TEST);
+		glActiveTexture(GL_TEXTURE31);
+	}
+	void draw_quads(unsigned vertex_array, unsigned atlas_texture, unsigned first_quad, unsigned quad_count, glm::vec2 offset) override
+	{
+		if (offset != current_offset)
+		{
+			glUniform2f(offset_location, offset.x, offset.y);
+			current_offset = offset;
+		}
+		glBindVertexArray(vertex_array);
+		glBindTexture(GL_TEXTURE_2D, atlas_texture);
+		glDrawArrays(GL_TRIANGLES, first_quad * 6, quad_count * 6);
+	}
+	void end_quads() override
+	{
+		if (current_offset != glm::vec2(0.0f))
+			glUniform2f(offset_location, 0.0f, 0.0f); // Unshared messages are laid out at their final position.
+ 
+		glEnable(GL_DEPTH_TEST);
+		glActiveTexture(GL_TEXTURE0);
+		glBindVertexArray(0);
+	}
+ 
+	void begin_clip(int left, int top, int width, int height) override
+	{
+		glGetIntegerv(GL_SCISSOR_BOX, previous_scissor);
+		scissor_enabled = glIsEnabled(GL_SCISSOR_TEST);
+ 
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+ 
+		glEnable(GL_SCISSOR_TEST);
+		glScissor(left, viewport[3] - (top + height), width, height); // GL's scissor box is from the bottom-left.
+	}
+	void end_clip() override
+	{
+		glScissor(previous_scissor[0], previous_scissor[1], previous_scissor[2], previous_scissor[3]);
+ 
+		if (!scissor_enabled)
+			glDisable(GL_SCISSOR_TEST);
+	}
+ 
+	void begin_grids(unsigned grid_program) override
+	{
+		glGetIntegerv(GL_CURRENT_PROGRAM, &previous_program);
+ 
+		glUseProgram(grid_program);
+		glUniform1i(glGetUniformLocation(grid_program, "alphabet_texture"), 31);
+		glUniform1i(glGetUniformLocation(grid_program, "cell_texture"), 30);
+		glUniform1i(glGetUniformLocation(grid_program, "glyph_table"), 29);
+		cell_size_location = glGetUniformLocation(grid_program, "cell_size");
+ 
+		glDisable(GL_DEPTH_TEST);
+	}
+	void draw_grid(unsigned vertex_array, unsigned atlas_texture, unsigned cell_texture, unsigned glyph_table_texture, int cell_width, int cell_height) override
+	{
+		glUniform2f(cell_size_location, (float)cell_width, (float)cell_height);
+ 
+		glActiveTexture(GL_TEXTURE31);
+		glBindTexture(GL_TEXTURE_2D, atlas_texture);
+		glActiveTexture(GL_TEXTURE30);
+		glBindTexture(GL_TEXTURE_2D, cell_texture);
+		glActiveTexture(GL_TEXTURE29);
+		glBindTexture(GL_TEXTURE_2D, glyph_table_texture);
+ 
+		glBindVertexArray(vertex_array);
+		glDrawArrays(GL_TRIANGLES, 0, 6);
+	}
+	void end_grids() override
+	{
+		glEnable(GL_DEPTH_TEST);
+		glActiveTexture(GL_TEXTURE0);
+		glBindVertexArray(0);
+ 
+		glUseProgram(previous_program);
+	}
+ 
+private:
+	GLint offset_location = -1; // Set in: begin_quads()
+	glm::vec2 current_offset = glm::vec2(0.0f);
+ 
+	GLint previous_scissor[4] = { 0, 0, 0, 0 };
+	GLboolean scissor_enabled = GL_FALSE;
+ 
+	GLint previous_program = 0;
+	GLint cell_size_location = -1;
+ 
+	static GLenum gl_usage(Text_Buffer_Usage usage)
+	{
+		switch (usage)
+		{
+		case Text_Buffer_Usage::static_draw:
+			return GL_STATIC_DRAW;
+		case Text_Buffer_Usage::dynamic_draw:
+			return GL_DYNAMIC_DRAW;
+		default:
+			return GL_STREAM_DRAW;
+		}
+	}
+};
@@ -6,28 +6,44 @@ uniform bool isShadow;
 uniform sampler2D alphabet_texture;
  
 in vec2 texture_coordinates;
+flat in uint span_attributes; // Bits 0-23 = RGB, 24-27 = style, 28 = shadow, 31 = has a span (packed in: upload_span_attributes)
  
 out vec4 fragment_colour;
  
 void main(void)
 {		
 	float texture_value = texture(alphabet_texture, texture_coordinates).r;
+ 
+	vec3 colour = font_colour;
+	bool shadow = isShadow;
+ 
+	if ((span_attributes & 0x80000000u) != 0u)
+	{
+		colour = vec3(span_attributes & 0xFFu, (span_attributes >> 8) & 0xFFu, (span_attributes >> 16) & 0xFFu);
+		shadow = shadow || ((span_attributes >> 28) & 1u) != 0u;
+ 
+		if (((span_attributes >> 24) & 0xFu) == 1u) // Bold: widen each stroke by 1 texel either side (the atlas padding keeps neighbouring glyphs out of reach)
+		{
+			vec2 texel = vec2(1.0 / float(textureSize(alphabet_texture, 0).x), 0.0);
+			texture_value = max(texture_value, max(texture(alphabet_texture, texture_coordinates - texel).r, texture(alphabet_texture, texture_coordinates + texel).r));
+		}
+	}
 	// Enable this if-statement for 2D window-positioned text
 	// -------------------------------------------------------------------------
-	if (!isShadow)
+	if (!shadow)
 		 if (texture_value == 1) // Fully opaque character pixels.
 		 {
-			 fragment_colour = vec4(font_colour / 255, texture_value);
+			 fragment_colour = vec4(colour / 255, texture_value);
 				 // fragment_colour = vec4(255 / 255, 255 / 255, 255 / 255, 1.0);
 		 }
 		 else if (texture_value == 0) // Fully transparent, i.e. background pixels (Note: you cannot use the "discard" method as used for 3D text further down, if colouring in the font's background)
 		 {
-			 fragment_colour = vec4(font_colour / 255, texture_value);
+			 fragment_colour = vec4(colour / 255, texture_value);
 				 // fragment_colour = vec4(85.0 / 255, 160.0 / 255, 155.0 / 255, 1.0);
 		 }
 		 else // Anti-aliased character pixels.
 		 {
-			 fragment_colour = vec4(font_colour / 255, texture_value);
+			 fragment_colour = vec4(colour / 255, texture_value);
 				 // fragment_colour = vec4(255 / 255, 255 / 255, 255 / 255, 1.0);
 		 }
 	else
@@ -1,11 +1,17 @@
 #version 420 core
  
 layout (location = 0) in vec4 vertex;
+layout (location = 1) in uint glyph_attributes; // Rich-text span (colour, style, shadow)... 0 when the message has no spans.
  
 out vec2 texture_coordinates;
+flat out uint span_attributes;
+ 
+uniform vec2 message_offset; // Start position of messages sharing a cached glyph run (0, 0 otherwise)
+uniform mat4 projection; // Layout pixels -> OpenGL [-1, 1]... set via: Text::upload_projection(...)
  
 void main(void)
 {	
 	texture_coordinates = vec2(vertex[2], vertex[3]);
-	gl_Position = vec4(vertex.xy, 0.0, 1.0);
+	span_attributes = glyph_attributes;
+	gl_Position = projection * vec4(vertex.xy + message_offset, 0.0, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,33 @@
+#version 420 core
+ 
+uniform sampler2D alphabet_texture;
+uniform usampler2D cell_texture; // 1 texel per cell: bits 0-15 = glyph index + 1 (0 = empty), bits 16-31 = RGB565 colour.
+uniform isampler2D glyph_table; // Per glyph... row 0 = atlas rectangle (x, y, width, height), row 1 = offset of that rectangle within a cell (x, y)
+uniform vec2 cell_size;
+ 
+in vec2 grid_pixel;
+ 
+out vec4 fragment_colour;
+ 
+void main(void)
+{
+	ivec2 cell = ivec2(grid_pixel / cell_size);
+	uint packed = texelFetch(cell_texture, cell, 0).r;
+ 
+	if ((packed & 0xFFFFu) == 0u)
+		discard;
+ 
+	int glyph = int(packed & 0xFFFFu) - 1;
+	ivec4 atlas_rect = texelFetch(glyph_table, ivec2(glyph, 0), 0);
+	ivec4 cell_offset = texelFetch(glyph_table, ivec2(glyph, 1), 0);
+ 
+	vec2 glyph_pixel = grid_pixel - vec2(cell) * cell_size - vec2(cell_offset.xy); // Both the cell & the atlas rows run top-down.
+ 
+	if (any(lessThan(glyph_pixel, vec2(0.0))) || any(greaterThanEqual(glyph_pixel, vec2(atlas_rect.zw))))
+		discard;
+ 
+	float texture_value = texelFetch(alphabet_texture, atlas_rect.xy + ivec2(glyph_pixel), 0).r;
+	vec3 colour = vec3(float((packed >> 27) & 0x1Fu) / 31.0, float((packed >> 21) & 0x3Fu) / 63.0, float((packed >> 16) & 0x1Fu) / 31.0);
+ 
+	fragment_colour = vec4(colour, texture_value);
+}
\ No newline at end of file
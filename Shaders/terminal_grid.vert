@@ -0,0 +1,13 @@
+#version 420 core
+ 
+layout (location = 0) in vec4 vertex; // x, y = position... z, w = pixels from the grid's top-left.
+ 
+out vec2 grid_pixel;
+ 
+uniform mat4 projection; // Layout pixels -> OpenGL [-1, 1]... set via: Text::upload_projection(...)
+ 
+void main(void)
+{	
+	grid_pixel = vec2(vertex[2], vertex[3]);
+	gl_Position = projection * vec4(vertex.xy, 0.0, 1.0);
+}
\ No newline at end of file